@@ -11,6 +11,25 @@
 #include "sntools.h"
 #include "sntools_cosmology.h"
 
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <immintrin.h>
+#endif
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+
+// Oct 2026: Gauss-Legendre nodes and weights on [-1,1] for 
+// per-bin integrals (distance table, SFR table, gradients)
+static const double xGL_HzFUN[NGL_HzFUN] = 
+  { -0.8611363115940526, -0.3399810435848563,
+     0.3399810435848563,  0.8611363115940526 } ;
+static const double wGL_HzFUN[NGL_HzFUN] = 
+  {  0.3478548451374538,  0.6521451548625461,
+     0.6521451548625461,  0.3478548451374538 } ;
+
 // ***********************************
 void init_HzFUN_INFO(int VBOSE, double *cosPar, char *fileName, 
 		     HzFUN_INFO_DEF *HzFUN_INFO) {
@@ -22,57 +41,33 @@ void init_HzFUN_INFO(int VBOSE, double *cosPar, char *fileName,
   // If fileName contains string OUT or out, then interpret
   // as output file to write H(z) using cosPar params, and
   // then read it back.
+  //
+  // Oct 2026: build cumulative distance table (see init_HzFUN_TABLE)
+  // Oct 2026: precision tier is STANDARD; see set_HzFUN_PRECISION
+  // Oct 2026: closed-form LCDM distance (see init_HzFUN_LCDM)
+  // Oct 2026: map arrays sized from number of rows (no MXMAP_HzFUN),
+  //           and map is resampled on uniform grid (init_HzFUN_MAPGRID)
+  // Oct 2026: map reading moved to read_HzFUN_MAP; see also 
+  //           create_HzFUN_INFO for instances with shared map/tables.
+  // Oct 2026: HzFUN_INFO is overwritten without freeing; before
+  //           re-init of the same struct (e.g., one struct for each 
+  //           point of a cosmology grid), call free_HzFUN_INFO.
 
-  int ipar;
-  int MEMD   = MXMAP_HzFUN * sizeof(double);
-  bool WR_OUTFILE;
   char fnam[] = "init_HzFUN_INFO";
 
   // ----------- BEGIN ------------
 
   if ( VBOSE ) {  print_banner(fnam); }
 
-  // always store COSPAR_LIST ... even for map where analytic H(z,COSPAR)
-  // is used at very low redshifts for integrals starting from z=0.
-  for(ipar=0; ipar < NCOSPAR_HzFUN; ipar++ ) 
-    { HzFUN_INFO->COSPAR_LIST[ipar] = cosPar[ipar]; }
-
-  HzFUN_INFO->Nzbin_MAP = 0;
+  set_HzFUN_DEFAULTS(cosPar, HzFUN_INFO);
 
   // - - - - - - 
   HzFUN_INFO->USE_MAP = !IGNOREFILE(fileName) ;
-  WR_OUTFILE = (strstr(fileName,"OUT") != NULL || 
-		strstr(fileName,"out") != NULL ) ;
 
   if ( HzFUN_INFO->USE_MAP ) {
-
-    HzFUN_INFO->FILENAME = (char*) malloc( MXPATHLEN * sizeof(char) );
-    sprintf(HzFUN_INFO->FILENAME, "%s", fileName);
-
-    // check debug option to write H(z) to file using COSPAR_LIST,
-    // and then read it like any other HzFUN file
-    if ( WR_OUTFILE ) { write_HzFUN_FILE(HzFUN_INFO);  }
-
-    // read 2 column map of H(z)
-    printf("   Read H(z) map from: %s \n", fileName );
-    HzFUN_INFO->zCMB_MAP  = (double*) malloc(MEMD);
-    HzFUN_INFO->HzFUN_MAP = (double*) malloc(MEMD);
-    rd2columnFile(fileName, MXMAP_HzFUN, &HzFUN_INFO->Nzbin_MAP,
-		  HzFUN_INFO->zCMB_MAP, HzFUN_INFO->HzFUN_MAP  );
-
-    int Nzbin   = HzFUN_INFO->Nzbin_MAP;
-    double zmin = HzFUN_INFO->zCMB_MAP[0]  ;
-    double zmax = HzFUN_INFO->zCMB_MAP[Nzbin-1]  ;
-
-    printf("\t Found %d redshift bins from %f to %f \n",
-	   Nzbin, zmin, zmax ); fflush(stdout);
-
-    // require first z-element to be zero
-    if ( zmin != 0.0 ) {
-      sprintf(c1err,"zCMB_min=%f, but must be zero.", zmin );
-      sprintf(c2err,"Check H(z) map.") ;
-      errmsg(SEV_FATAL, 0, fnam, c1err, c2err);
-    }
+    read_HzFUN_MAP(VBOSE, fileName, HzFUN_INFO);
+    if ( HzFUN_INFO->MMAP_TABLE ) 
+      { init_MUINV_TABLE(VBOSE, HzFUN_INFO);  return ; }
   }
   else {
     // COSPAR_LIST already loaded above.
@@ -95,478 +90,4291 @@ void init_HzFUN_INFO(int VBOSE, double *cosPar, char *fileName,
       fflush(stdout) ;
     }
 
+    // closed-form distance for LCDM
+    init_HzFUN_LCDM(HzFUN_INFO);
   }
 
+  // tabulate comoving distance so that integrals become lookups
+  init_HzFUN_TABLE(VBOSE, HzFUN_INFO);
+
   return ;
 
 } // end init_HzFUN_INFO
 
 
 // ****************************************
-void write_HzFUN_FILE(HzFUN_INFO_DEF *HzFUN_INFO ) {
+void set_HzFUN_DEFAULTS(double *cosPar, HzFUN_INFO_DEF *HzFUN_INFO) {
 
-  // BEWARE: FOR DEBUG ONLY !
-  // write 2-column H(z) to text file, which is used
-  // to test reading H(z) file. Write in log(z) bins
-  // to make sure it can read non-uniform bins.
-  // Goal is to compare analytic Hzfun_wCDM with Hzfun_interp.
+  // Created Oct 2026 (moved from init_HzFUN_INFO)
+  // Store cosPar and set default options; no map, tables or payloads.
+
+  int ipar ;
+
+  // always store COSPAR_LIST ... even for map where analytic H(z,COSPAR)
+  // is used at very low redshifts for integrals starting from z=0.
+  for(ipar=0; ipar < NCOSPAR_HzFUN; ipar++ ) 
+    { HzFUN_INFO->COSPAR_LIST[ipar] = cosPar[ipar]; }
+
+  HzFUN_INFO->IPREC      = IPREC_HzFUN_STANDARD ;
+  HzFUN_INFO->USE_SHARED = false ;
+  HzFUN_INFO->NREF       = 0 ;
+  HzFUN_INFO->SHARED_MAP   = NULL ;
+  HzFUN_INFO->SHARED_TABLE = NULL ;
+  HzFUN_INFO->USE_MAP    = false ;
+  HzFUN_INFO->Nzbin_MAP  = 0;
+  HzFUN_INFO->Nzbin_GRID = 0;
+  HzFUN_INFO->OPT_INTERP_MAP = OPT_INTERP_HzFUN_MAP_LINEAR ;
+  HzFUN_INFO->USE_TABLE  = false ;
+  HzFUN_INFO->Nbin_MUINV = 0 ;
+  HzFUN_INFO->H0REF_TABLE = cosPar[ICOSPAR_HzFUN_H0] ;
+  HzFUN_INFO->SCALE_TABLE = 1.0 ;
+  HzFUN_INFO->DMU_MUINV   = 0.0 ;
+  HzFUN_INFO->USE_MMAP   = false ;
+  HzFUN_INFO->MMAP_TABLE = false ;
+  HzFUN_INFO->USE_LCDM_CLOSED = false ;
+
+} // end set_HzFUN_DEFAULTS
+
+
+// ****************************************
+bool is_HzFUN_MAP_OUTFILE(char *fileName) {
+  // Created Oct 2026: true for debug map fileName with OUT or out,
+  // which is written from COSPAR_LIST (see read_HzFUN_MAP).
+  return ( strstr(fileName,"OUT") != NULL || 
+	   strstr(fileName,"out") != NULL ) ;
+} // end is_HzFUN_MAP_OUTFILE
+
+
+// ****************************************
+void read_HzFUN_MAP(int VBOSE, char *fileName, HzFUN_INFO_DEF *HzFUN_INFO) {
+
+  // Created Oct 2026 (moved from init_HzFUN_INFO)
+  // Read text or binary H(z) map and resample text map on uniform
+  // grid. Map arrays are sized from the number of rows, and FILENAME
+  // from the length of fileName. No distance tables are built here.
   //
-  char *outFile = HzFUN_INFO->FILENAME;
-  double zCMB_min = 0.005;
-  double zCMB_max = ZMAX_SNANA ;
-  double logz_min = log10(zCMB_min);
-  double logz_max = log10(zCMB_max);
-  int    Nzbin    = 200 ;
-  double logz_bin = (logz_max - logz_min) / (double)Nzbin;
+  // If fileName contains string OUT or out, then interpret
+  // as output file to write H(z) using COSPAR_LIST, and
+  // then read it back.
 
-  FILE *fp; 
-  double logz, z, Hz ;
-  int  iz;
-  char fnam[] = "write_HzFUN_FILE" ;
-  
-  // ---------- BEGIN ------------
+  int  NROW, MEMD ;
+  bool WR_OUTFILE;
+  char fnam[] = "read_HzFUN_MAP";
 
-  printf("   Write H(z) to %s \n", outFile); 
-  printf("\t %d bins for zCMB = %.4f to %.4f \n", 
-	 Nzbin, zCMB_min, zCMB_max);
-  printf("\t logz(min,max,bin) = %f, %f, %f \n",
-	 logz_min, logz_max, logz_bin );
-  fflush(stdout);
+  // ----------- BEGIN ------------
 
-  fp = fopen(outFile,"wt");
-  if ( !fp ) {
-    sprintf(c1err,"Unable to open '%s' in write-text mode");
-    sprintf(c2err,"Check permisssions and if file already exists.") ;
+  HzFUN_INFO->USE_MAP  = true ;
+  HzFUN_INFO->FILENAME = (char*) malloc( strlen(fileName) + 1 );
+  sprintf(HzFUN_INFO->FILENAME, "%s", fileName);
+
+  // check debug option to write H(z) to file using COSPAR_LIST,
+  // and then read it like any other HzFUN file
+  WR_OUTFILE = is_HzFUN_MAP_OUTFILE(fileName);
+  if ( WR_OUTFILE ) { write_HzFUN_FILE(HzFUN_INFO);  }
+
+  // Oct 2026: check for binary map (see convert_HzFUN_MAP)
+  if ( is_HzFUN_BINARY(fileName) ) {
+    read_HzFUN_BINARY(VBOSE, fileName, HzFUN_INFO);
+    return ;
+  }
+
+  // read 2 column map of H(z)
+  printf("   Read H(z) map from: %s \n", fileName );
+  NROW = nrow_read(fileName, fnam) + 10 ;
+  MEMD = NROW * sizeof(double);
+  HzFUN_INFO->zCMB_MAP  = (double*) malloc(MEMD);
+  HzFUN_INFO->HzFUN_MAP = (double*) malloc(MEMD);
+  rd2columnFile(fileName, NROW, &HzFUN_INFO->Nzbin_MAP,
+		HzFUN_INFO->zCMB_MAP, HzFUN_INFO->HzFUN_MAP  );
+
+  int Nzbin   = HzFUN_INFO->Nzbin_MAP;
+  double zmin = HzFUN_INFO->zCMB_MAP[0]  ;
+  double zmax = HzFUN_INFO->zCMB_MAP[Nzbin-1]  ;
+
+  printf("\t Found %d redshift bins from %f to %f \n",
+	 Nzbin, zmin, zmax ); fflush(stdout);
+
+  // require first z-element to be zero
+  if ( zmin != 0.0 ) {
+    sprintf(c1err,"zCMB_min=%f, but must be zero.", zmin );
+    sprintf(c2err,"Check H(z) map.") ;
     errmsg(SEV_FATAL, 0, fnam, c1err, c2err);
   }
 
+  init_HzFUN_MAPGRID(VBOSE, HzFUN_INFO);
 
-  // write documentation keys
-  fprintf(fp,"DOCUMENTATION: \n");
-  fprintf(fp,"  NOTES: \n");
-  fprintf(fp,"  - Auto generated by snlc_sim.exe  \n");
-  fprintf(fp,"  COSPAR: \n");
-  fprintf(fp,"    H0: %.2f \n" ,HzFUN_INFO->COSPAR_LIST[ICOSPAR_HzFUN_H0] );
-  fprintf(fp,"    OM: %.4f \n" ,HzFUN_INFO->COSPAR_LIST[ICOSPAR_HzFUN_OM] );
-  fprintf(fp,"    OL: %.4f \n" ,HzFUN_INFO->COSPAR_LIST[ICOSPAR_HzFUN_OL] );
-  fprintf(fp,"    w0: %.2f \n" ,HzFUN_INFO->COSPAR_LIST[ICOSPAR_HzFUN_w0] );
-  fprintf(fp,"    wa: %.2f \n" ,HzFUN_INFO->COSPAR_LIST[ICOSPAR_HzFUN_wa] );
-  fprintf(fp, "DOCUMENTATION_END: \n\n");
+} // end read_HzFUN_MAP
 
-  // turn off map use temporarily so that COSPAR is used in Hzfun().
 
-  HzFUN_INFO->USE_MAP = false ;
-  for(iz=0; iz < Nzbin; iz++ ) {
-    if ( iz == 0 )
-      { z = 0.0 ; }
+// ****************************************
+void init_HzFUN_MAPGRID(int VBOSE, HzFUN_INFO_DEF *HzFUN_INFO) {
+
+  // Created Oct 2026
+  // Resample H(z) map (zCMB_MAP, HzFUN_MAP) onto a uniform z grid 
+  // from 0 to the last map redshift, so that Hzfun_interp computes
+  // the bin index directly instead of searching the map.
+  // Grid binsize is half the smallest map z-spacing, but no larger 
+  // than DZMAX_HzFUN_MAPGRID and no smaller than zmax/MXGRID_HzFUN_MAP.
+  //
+  // OPT_INTERP_MAP = LINEAR : grid H is linear interp of map, and
+  //                  Hzfun_interp is linear on grid.
+  // OPT_INTERP_MAP = PCHIP  : monotone cubic through map nodes
+  //                  (Fritsch-Carlson slopes); grid stores H and 
+  //                  dH/dz, and Hzfun_interp is cubic Hermite.
+
+  int    Nmap   = HzFUN_INFO->Nzbin_MAP ;
+  double *zMAP  = HzFUN_INFO->zCMB_MAP ;
+  double *HzMAP = HzFUN_INFO->HzFUN_MAP ;
+  int    OPT    = HzFUN_INFO->OPT_INTERP_MAP ;
+  double zmax   = zMAP[Nmap-1] ;
+  double *DELTA, *SLOPE, dzmin, dz, z, h, t, t1, w1, w2 ;
+  int    Ngrid, i, k, MEMD ;
+  char   fnam[] = "init_HzFUN_MAPGRID" ;
+
+  // ------------ BEGIN -------------
+
+  if ( Nmap < 2 ) {
+    sprintf(c1err,"Found %d rows in H(z) map; need at least 2.", Nmap);
+    sprintf(c2err,"Check H(z) map %s", HzFUN_INFO->FILENAME) ;
+    errmsg(SEV_FATAL, 0, fnam, c1err, c2err);
+  }
+
+  // slopes of map segments; check that zCMB is increasing
+  MEMD  = Nmap * sizeof(double);
+  DELTA = (double*) malloc(MEMD);
+  SLOPE = (double*) malloc(MEMD);
+  dzmin = zmax ;
+  for(k=0; k < Nmap-1; k++ ) {
+    h = zMAP[k+1] - zMAP[k] ;
+    if ( h <= 0.0 ) {
+      sprintf(c1err,"zCMB_MAP not increasing: z[%d]=%f, z[%d]=%f", 
+	      k, zMAP[k], k+1, zMAP[k+1] );
+      sprintf(c2err,"Check H(z) map %s", HzFUN_INFO->FILENAME) ;
+      errmsg(SEV_FATAL, 0, fnam, c1err, c2err);
+    }
+    if ( h < dzmin ) { dzmin = h; }
+    DELTA[k] = (HzMAP[k+1] - HzMAP[k]) / h ;
+  }
+
+  // Fritsch-Carlson (Fritsch-Butland) slopes at map nodes
+  SLOPE[0] = DELTA[0];  SLOPE[Nmap-1] = DELTA[Nmap-2];
+  for(k=1; k < Nmap-1; k++ ) {
+    SLOPE[k] = 0.0 ;
+    if ( DELTA[k-1]*DELTA[k] > 0.0 ) {
+      h  = zMAP[k+1] - zMAP[k] ;  t = zMAP[k] - zMAP[k-1] ;
+      w1 = 2.0*h + t ;  w2 = h + 2.0*t ;
+      SLOPE[k] = (w1+w2) / ( w1/DELTA[k-1] + w2/DELTA[k] ) ;
+    }
+  }
+
+  dz = 0.5 * dzmin ;
+  if ( dz > DZMAX_HzFUN_MAPGRID ) { dz = DZMAX_HzFUN_MAPGRID; }
+  if ( dz < zmax/(double)MXGRID_HzFUN_MAP ) 
+    { dz = zmax/(double)MXGRID_HzFUN_MAP; }
+  Ngrid = (int)ceil( zmax/dz - 1.0E-9 ) ;
+  dz    = zmax / (double)Ngrid ;
+
+  HzFUN_INFO->Nzbin_GRID = Ngrid + 1 ;
+  HzFUN_INFO->dz_GRID    = dz ;
+  HzFUN_INFO->zmax_GRID  = zmax ;
+  MEMD = (Ngrid+1) * sizeof(double);
+  HzFUN_INFO->Hz_GRID    = (double*) malloc(MEMD);
+  HzFUN_INFO->dHdz_GRID  = (double*) malloc(MEMD);
+
+  k = 0 ;
+  for(i=0; i <= Ngrid; i++ ) {
+    z = dz * (double)i ;
+    if ( i == Ngrid ) { z = zmax; }
+    while ( k < Nmap-2 && z > zMAP[k+1] ) { k++ ; }
+    h  = zMAP[k+1] - zMAP[k] ;
+    t  = (z - zMAP[k]) / h ;  t1 = 1.0 - t ;
+
+    if ( OPT == OPT_INTERP_HzFUN_MAP_PCHIP ) {
+      HzFUN_INFO->Hz_GRID[i] = 
+	(1.0+2.0*t)*t1*t1*HzMAP[k] + t*t*(3.0-2.0*t)*HzMAP[k+1] +
+	h * ( t*t1*t1*SLOPE[k] - t*t*t1*SLOPE[k+1] ) ;
+      HzFUN_INFO->dHdz_GRID[i] = 
+	6.0*t*t1*DELTA[k] + t1*(1.0-3.0*t)*SLOPE[k] + t*(3.0*t-2.0)*SLOPE[k+1];
+    }
     else {
-      logz = logz_min + logz_bin * (double)(iz-1) ;
-      z    = pow(TEN,logz);
+      HzFUN_INFO->Hz_GRID[i]   = HzMAP[k] + t*(HzMAP[k+1]-HzMAP[k]) ;
+      HzFUN_INFO->dHdz_GRID[i] = DELTA[k] ;
     }
-    Hz   = Hzfun(z,HzFUN_INFO);
-    fprintf(fp," %7.5f  %9.4f\n", z, Hz);
   }
 
-  fclose(fp);
-  HzFUN_INFO->USE_MAP = true ; // restore using map
+  if ( VBOSE ) {
+    printf("\t Resample H(z) map on %d uniform bins (dz=%.2e, %s interp)\n",
+	   Ngrid, dz, 
+	   (OPT == OPT_INTERP_HzFUN_MAP_PCHIP) ? "PCHIP" : "linear" );
+    fflush(stdout);
+  }
 
+  free(DELTA);  free(SLOPE);
   return ;
 
-} // end write_HzFUN_FILE
+} // end init_HzFUN_MAPGRID
 
 
-// ****************************
-double SFR_integral(double z, HzFUN_INFO_DEF *HzFUN_INFO) {
+// ****************************************
+void set_HzFUN_MAP_INTERP(int OPT_INTERP, HzFUN_INFO_DEF *HzFUN_INFO) {
 
-  /***
-   Integrate SFR(t) from 0 to current time.
-   For convenience, integrate  over 'a' instead of redshift
-   [since z goes to infinity]
- 
-        /a
-       |   SFR(a') 
-     c |  ----------- da'
-       |  a' * H(a')
-       /0
+  // Created Oct 2026
+  // Change interpolation option (OPT_INTERP_HzFUN_MAP_XXX) for H(z)
+  // map, and rebuild grid and distance tables. No effect without map.
 
-  ***/
+  char fnam[] = "set_HzFUN_MAP_INTERP" ;
 
-  double H0 = HzFUN_INFO->COSPAR_LIST[ICOSPAR_HzFUN_H0];
-  int    ia, NABIN = 100 ;
-  double AMIN, AMAX, ABIN, atmp, ztmp, xa, tmp  ;
-  double sum, sfr, aH ;
+  if ( OPT_INTERP != OPT_INTERP_HzFUN_MAP_LINEAR && 
+       OPT_INTERP != OPT_INTERP_HzFUN_MAP_PCHIP ) {
+    sprintf(c1err,"Invalid OPT_INTERP = %d", OPT_INTERP);
+    sprintf(c2err,"Valid options: %d(linear), %d(PCHIP)",
+	    OPT_INTERP_HzFUN_MAP_LINEAR, OPT_INTERP_HzFUN_MAP_PCHIP);
+    errmsg(SEV_FATAL, 0, fnam, c1err, c2err);
+  }
 
-  double SECONDS_PER_YEAR = 3600. * 24. * 365. ;
+  if ( HzFUN_INFO->USE_MMAP && OPT_INTERP != HzFUN_INFO->OPT_INTERP_MAP ) {
+    sprintf(c1err,"Cannot change OPT_INTERP for binary map %.150s",
+	    HzFUN_INFO->FILENAME);
+    sprintf(c2err,"Re-create binary map with OPT_INTERP=%d", OPT_INTERP);
+    errmsg(SEV_FATAL, 0, fnam, c1err, c2err);
+  }
+  if ( HzFUN_INFO->USE_MMAP ) { return ; }
+
+  if ( !HzFUN_INFO->USE_MAP ) 
+    { HzFUN_INFO->OPT_INTERP_MAP = OPT_INTERP ;  return ; }
+
+  if ( HzFUN_INFO->USE_SHARED ) {
+    // switch to (shared) payloads for this OPT_INTERP
+    if ( OPT_INTERP == HzFUN_INFO->OPT_INTERP_MAP ) { return ; }
+    char *fileName = HzFUN_INFO->SHARED_MAP->FILENAME ;
+    HzFUN_SHARED_DEF *MAP_OLD = HzFUN_INFO->SHARED_MAP ;
+    if ( HzFUN_INFO->SHARED_TABLE ) 
+      { release_HzFUN_SHARED(HzFUN_INFO->SHARED_TABLE); }
+    HzFUN_INFO->SHARED_TABLE = NULL ;
+    get_HzFUN_SHARED_MAP(0, fileName, OPT_INTERP, HzFUN_INFO);
+    release_HzFUN_SHARED(MAP_OLD);
+    get_HzFUN_SHARED_TABLE(0, HzFUN_INFO);
+    return ;
+  }
 
-  // ---------- BEGIN ------------
+  HzFUN_INFO->OPT_INTERP_MAP = OPT_INTERP ;
+  if ( HzFUN_INFO->Nzbin_GRID > 0 ) 
+    { free(HzFUN_INFO->Hz_GRID);  free(HzFUN_INFO->dHdz_GRID); }
+  init_HzFUN_MAPGRID(0, HzFUN_INFO);
 
-  AMIN = 0.0 ;
-  AMAX = 1. / (1. + z) ;
-  ABIN = (AMAX - AMIN) / (double)NABIN ;
+  if ( HzFUN_INFO->USE_TABLE ) 
+    { free(HzFUN_INFO->DC_TABLE);  free(HzFUN_INFO->EINV_TABLE); }
+  if ( HzFUN_INFO->Nbin_MUINV > 0 ) 
+    { free(HzFUN_INFO->zCMB_MUINV);  free(HzFUN_INFO->dzdmu_MUINV); }
+  HzFUN_INFO->Nbin_MUINV = 0 ;
+  init_HzFUN_TABLE(0, HzFUN_INFO);
 
-  sum = 0.0 ;
+} // end set_HzFUN_MAP_INTERP
+
+
+// ****************************************
+void free_HzFUN_INFO(HzFUN_INFO_DEF *HzFUN_INFO) {
 
-  for ( ia=1; ia <= NABIN; ia++ ) {
-    xa   = (double)ia ;
-    atmp = AMIN + ABIN * ( xa - 0.5 ) ;
-    ztmp = (1. / atmp) - 1.0 ;
+  // Created Oct 2026
+  // Free memory allocated in init_HzFUN_INFO (map, grid, tables),
+  // or unmap binary map file. COSPAR_LIST is kept.
+  // Oct 2026: for instance from create_HzFUN_INFO, release shared
+  //           payloads instead (see release_HzFUN_INFO).
 
-    sfr = SFRfun_BG03(ztmp,H0);
-    aH  = atmp * Hzfun(ztmp, HzFUN_INFO);
-    sum += sfr / aH ;
+  if ( HzFUN_INFO->SHARED_TABLE != NULL ) 
+    { release_HzFUN_SHARED(HzFUN_INFO->SHARED_TABLE); }
+  else {
+    if ( HzFUN_INFO->USE_TABLE && !HzFUN_INFO->MMAP_TABLE ) 
+      { free(HzFUN_INFO->DC_TABLE);  free(HzFUN_INFO->EINV_TABLE); }
+    if ( HzFUN_INFO->Nbin_MUINV > 0 ) 
+      { free(HzFUN_INFO->zCMB_MUINV);  free(HzFUN_INFO->dzdmu_MUINV); }
   }
 
-  // convert H (km/s/Mpc) to H(/year)
+  if ( HzFUN_INFO->SHARED_MAP != NULL ) 
+    { release_HzFUN_SHARED(HzFUN_INFO->SHARED_MAP); }
+  else if ( HzFUN_INFO->USE_MAP ) {
+    if ( HzFUN_INFO->USE_MMAP ) 
+      { munmap(HzFUN_INFO->MMAP_ADDR, HzFUN_INFO->MMAP_SIZE); }
+    else {
+      free(HzFUN_INFO->zCMB_MAP);  free(HzFUN_INFO->HzFUN_MAP);
+      if ( HzFUN_INFO->Nzbin_GRID > 0 ) 
+	{ free(HzFUN_INFO->Hz_GRID);  free(HzFUN_INFO->dHdz_GRID); }
+    }
+    free(HzFUN_INFO->FILENAME);
+  }
 
-  tmp = (1.0E6 * PC_km) / SECONDS_PER_YEAR ;
-  // xxx tmp = 1.0 / SECONDS_PER_YEAR ;
-  sum *= (ABIN * tmp) ;
-  return sum ;
+  HzFUN_INFO->SHARED_MAP   = NULL ;
+  HzFUN_INFO->SHARED_TABLE = NULL ;
+  HzFUN_INFO->USE_MAP    = false ;
+  HzFUN_INFO->USE_MMAP   = false ;
+  HzFUN_INFO->USE_TABLE  = false ;
+  HzFUN_INFO->MMAP_TABLE = false ;
+  HzFUN_INFO->Nbin_MUINV = 0 ;
+  HzFUN_INFO->Nzbin_MAP  = 0 ;
+  HzFUN_INFO->Nzbin_GRID = 0 ;
 
-}  // end of function SFR_integral
+} // end free_HzFUN_INFO
 
 
-// ****************************
-double SFRfun_BG03(double z, double H0) {
+// ****************************************
+void set_HzFUN_PRECISION(int VBOSE, int IPREC, HzFUN_INFO_DEF *HzFUN_INFO) {
 
-  /***
-      Compute sfr(z) = (a+b*z)/(1+(z/c)^d)*h solar_mass/yr/Mpc^3
-      where H0 unit is km/s/Mpc and  h = H0/(100 km/s/Mpc)
-     
-      Oct 16 2020: rename SFRfun -> SFRfun_BG03
-  ***/
+  // Created Oct 2026
+  // Select precision tier IPREC = IPREC_HzFUN_[FAST,STANDARD,REFERENCE]
+  // (see sntools_cosmology.h) and rebuild distance and inverse tables 
+  // for this tier:
+  //   FAST      -> coarse tables + loose quadrature tolerance
+  //   STANDARD  -> tables and tolerance from init_HzFUN_INFO
+  //   REFERENCE -> no tables; every integral is adaptive quadrature
+  // A distance table read from a binary map file (MMAP_TABLE) is
+  // kept as is for FAST and STANDARD, and switched off for REFERENCE.
+  // Must not be called while other threads evaluate HzFUN_INFO.
 
-  // -- Baldry and Glazebrook IMF --
-  // https://ui.adsabs.harvard.edu/abs/2003ApJ...593..258B
+  char fnam[] = "set_HzFUN_PRECISION" ;
 
-  double a = 0.0118 ;
-  double b = 0.08 ;
-  double c = 3.3 ;
-  double d = 5.2 ;
-  double tmp1, tmp2, zc, h, SFRLOC;
+  // ----------- BEGIN ------------
 
-  // ------------ BEGIN --------------
-  zc   = z/c ;
-  tmp1 = a + b*z ;
-  tmp2 = 1.0 + pow(zc,d) ;
-  h    = H0 / 100. ; 
-  SFRLOC = h * tmp1 / tmp2 ;
-  return(SFRLOC) ;
-}  // end SFRfun_BG03
+  if ( IPREC < IPREC_HzFUN_FAST || IPREC > IPREC_HzFUN_REFERENCE ) {
+    sprintf(c1err,"Invalid IPREC = %d", IPREC);
+    sprintf(c2err,"Valid IPREC are %d(FAST), %d(STANDARD), %d(REFERENCE)",
+	    IPREC_HzFUN_FAST, IPREC_HzFUN_STANDARD, IPREC_HzFUN_REFERENCE);
+    errmsg(SEV_FATAL, 0, fnam, c1err, c2err);
+  }
 
+  if ( IPREC == HzFUN_INFO->IPREC ) { return ; }
 
-// *******************************************
-double SFRfun_MD14(double z, double *params) {
+  if ( VBOSE ) { 
+    printf("   %s: IPREC = %d -> %d \n", fnam, HzFUN_INFO->IPREC, IPREC);
+    fflush(stdout);
+  }
 
-  // Created Dec 2016 by R.Kessler
-  // use function from  Madau & Dickoson 2014,
-  // that was also used in Strolger 2015 for CC rate.
-  // This function intended for CC rate, so beware
-  // using for other purposes (e.g., no H0 factor here).
+  // free tables from previous tier
+  if ( HzFUN_INFO->SHARED_TABLE != NULL ) {
+    release_HzFUN_SHARED(HzFUN_INFO->SHARED_TABLE);
+    HzFUN_INFO->SHARED_TABLE = NULL ;
+    HzFUN_INFO->USE_TABLE    = false ;
+    HzFUN_INFO->Nbin_MUINV   = 0 ;
+  }
+  if ( HzFUN_INFO->Nbin_MUINV > 0 ) {
+    free(HzFUN_INFO->zCMB_MUINV);  free(HzFUN_INFO->dzdmu_MUINV); 
+    HzFUN_INFO->Nbin_MUINV = 0 ;
+  }
 
-  double A      = params[0];
-  double B      = params[1];
-  double C      = params[2];
-  double D      = params[3];
-  double z1     = 1.0 + z;
-  double top    = A*pow(z1,C);
-  double bottom = 1.0 + pow( (z1/B), D );
-  double SFR    = top/bottom; // also see Eq 8+9 of Strolger 2015 
-  return(SFR);
+  HzFUN_INFO->IPREC = IPREC ;
 
-} // end SFRfun_MD14
+  if ( HzFUN_INFO->MMAP_TABLE ) {
+    HzFUN_INFO->USE_TABLE = ( IPREC != IPREC_HzFUN_REFERENCE ) ;
+    init_MUINV_TABLE(VBOSE, HzFUN_INFO);
+    return ;
+  }
 
+  if ( HzFUN_INFO->USE_SHARED ) 
+    { get_HzFUN_SHARED_TABLE(VBOSE, HzFUN_INFO);  return ; }
 
+  if ( HzFUN_INFO->USE_TABLE ) {
+    free(HzFUN_INFO->DC_TABLE);  free(HzFUN_INFO->EINV_TABLE); 
+    HzFUN_INFO->USE_TABLE = false ;
+  }
+  init_HzFUN_TABLE(VBOSE, HzFUN_INFO);
 
-// *******************************************
-double dVdz_integral(int OPT, double zmax, HzFUN_INFO_DEF *HzFUN_INFO) {
+  return ;
+
+} // end set_HzFUN_PRECISION
 
-  //
-  // return integral of dV/dz = r(z)^2/H(z) dz
-  // OPT = 0:  returns standard volume integral
-  // OPT = 1:  returns  z-wgted integral
 
-  double sum, tmp, dz, ztmp, wz, xz ;
-  int Nzbin, iz;
+// ****************************************
+double get_TOLMAG_HzFUN(const HzFUN_INFO_DEF *HzFUN_INFO) {
+  // Created Oct 2026
+  // Return quadrature tolerance (mag) for precision tier of HzFUN_INFO
+  if ( HzFUN_INFO->IPREC == IPREC_HzFUN_FAST ) 
+    { return TOLMAG_INTEG_FAST; }
+  if ( HzFUN_INFO->IPREC == IPREC_HzFUN_REFERENCE ) 
+    { return TOLMAG_INTEG_REFERENCE; }
+  return TOLMAG_INTEG_DEFAULT ;
+} // end get_TOLMAG_HzFUN
 
-  // ---- BEGIN ----------
 
-  // compute exact integral
+// ****************************************
+void set_HzFUN_H0(double H0, HzFUN_INFO_DEF *HzFUN_INFO) {
+
+  // Created Oct 2026
+  // Change H0 in O(1), without rebuilding distance tables. H0 enters
+  // only as the overall scale c/H0:
+  //  * analytic H(z): DC(z) = int H0/H dz depends on (OM,OL,w0,wa)
+  //    only, and MU(z;H0) = MU(z;H0REF) - 5*log10(H0/H0REF) ; 
+  //    inverse-table lookups are shifted by DMU_MUINV.
+  //  * map: H(z) is absolute, so DC(z) scales as H0/H0REF 
+  //    (SCALE_TABLE), and MU(z) does not depend on H0 when flat.
+  // For a map with curvature MU(z) does not factorize, and the 
+  // inverse table is rebuilt (or re-attached if shared).
+  // Must not be called while other threads evaluate HzFUN_INFO.
+
+  bool REBUILD ;
 
-  Nzbin = (int)( zmax * 1000.0 ) ;
-  if ( Nzbin < 10 ) { Nzbin = 10 ; }
-  dz   = zmax / (float)Nzbin ;   // integration binsize
-  sum = 0.0;
+  // ----------- BEGIN ------------
 
-  for ( iz=0; iz < Nzbin; iz++ ) {
-    xz   = (double)iz ;
-    ztmp = dz * (xz + 0.5) ;
-    tmp  = dVdz(ztmp,HzFUN_INFO);
+  REBUILD = ( HzFUN_INFO->USE_MAP && is_HzFUN_CURVED(HzFUN_INFO) &&
+	      H0 != HzFUN_INFO->COSPAR_LIST[ICOSPAR_HzFUN_H0] ) ;
 
-    wz = 1.0;
-    if ( OPT == 1 ) { wz = ztmp; }
+  HzFUN_INFO->COSPAR_LIST[ICOSPAR_HzFUN_H0] = H0 ;
+  set_HzFUN_TABLE_SCALE(HzFUN_INFO);
 
-    sum += wz * tmp;
+  if ( !REBUILD ) { return ; }
 
+  if ( HzFUN_INFO->SHARED_TABLE != NULL ) {
+    release_HzFUN_SHARED(HzFUN_INFO->SHARED_TABLE);
+    get_HzFUN_SHARED_TABLE(0, HzFUN_INFO);
+  }
+  else if ( HzFUN_INFO->Nbin_MUINV > 0 ) {
+    free(HzFUN_INFO->zCMB_MUINV);  free(HzFUN_INFO->dzdmu_MUINV); 
+    init_MUINV_TABLE(0, HzFUN_INFO);
   }
 
-  sum *= dz ;
+} // end set_HzFUN_H0
 
-  //  printf(" xxxx dVdz_integral = %e (approx=%e) \n", sum, sumtmp  );
 
-  return sum ;
+// ****************************************
+void set_HzFUN_TABLE_SCALE(HzFUN_INFO_DEF *HzFUN_INFO) {
 
-}  // end of dVdz_integral
+  // Created Oct 2026
+  // Set SCALE_TABLE and DMU_MUINV from H0 and H0REF_TABLE 
+  // (see set_HzFUN_H0). For a map, the inverse table is always
+  // for the current H0, so DMU_MUINV=0.
 
+  double H0    = HzFUN_INFO->COSPAR_LIST[ICOSPAR_HzFUN_H0] ;
+  double H0REF = HzFUN_INFO->H0REF_TABLE ;
 
-double dvdz_integral__(int *OPT, double *zmax, double *COSPAR) {
-		       
-  HzFUN_INFO_DEF HzFUN_INFO;
-  int ipar;
+  HzFUN_INFO->SCALE_TABLE = 1.0 ;
+  HzFUN_INFO->DMU_MUINV   = 0.0 ;
+  if ( H0 == H0REF ) { return ; }
 
-  HzFUN_INFO.USE_MAP = false ;
-  for (ipar=0; ipar < NCOSPAR_HzFUN; ipar++ ) 
-    { HzFUN_INFO.COSPAR_LIST[ipar] = COSPAR[ipar]; }
+  if ( HzFUN_INFO->USE_MAP ) 
+    { HzFUN_INFO->SCALE_TABLE = H0 / H0REF ; }
+  else
+    { HzFUN_INFO->DMU_MUINV = 5.0 * log10(H0/H0REF) ; }
 
-  return dVdz_integral(*OPT, *zmax, &HzFUN_INFO);
-}
+} // end set_HzFUN_TABLE_SCALE
 
 
-// **********************************
-double dVdz(double z, HzFUN_INFO_DEF *HzFUN_INFO) {
-  // returns dV/dz = r(z)^2 / H(z)
-  double r, H, tmp ;
-  double zmin = 0.0;
-  r = Hzinv_integral (zmin, z, HzFUN_INFO);
-  H = Hzfun ( z, HzFUN_INFO);
-  tmp = LIGHT_km * r * r / H ;
-  return tmp;
-}  // end of dVdz
+// ****************************************
+void get_HzFUN_TABLE_KEY(const HzFUN_INFO_DEF *HzFUN_INFO, double *KEY) {
+
+  // Created Oct 2026
+  // Return key of distance and inverse tables: COSPAR_LIST with the 
+  // parameters that the tables do not depend on set to zero; i.e.,
+  // H0 (see set_HzFUN_H0), and w0,wa for a map. H0 is kept for a
+  // map with curvature, where the inverse table depends on H0.
+
+  int ipar ;
+  for(ipar=0; ipar < NCOSPAR_HzFUN; ipar++ ) 
+    { KEY[ipar] = HzFUN_INFO->COSPAR_LIST[ipar]; }
+
+  if ( HzFUN_INFO->USE_MAP ) {
+    KEY[ICOSPAR_HzFUN_w0] = KEY[ICOSPAR_HzFUN_wa] = 0.0 ;
+    if ( is_HzFUN_CURVED(HzFUN_INFO) ) { return ; }
+  }
+  KEY[ICOSPAR_HzFUN_H0] = 0.0 ;
+
+} // end get_HzFUN_TABLE_KEY
+
+
+// ****************************************
+bool is_HzFUN_CURVED(const HzFUN_INFO_DEF *HzFUN_INFO) {
+  // Created Oct 2026: true if curvature is applied in Hzinv_curvature
+  double OM = HzFUN_INFO->COSPAR_LIST[ICOSPAR_HzFUN_OM];
+  double OL = HzFUN_INFO->COSPAR_LIST[ICOSPAR_HzFUN_OL];
+  return ( fabs(1.0 - OM - OL) > 0.00001 ) ;
+} // end is_HzFUN_CURVED
+
+
+// ==================================================
+//   HzFUN_INFO lifecycle with shared payloads (Oct 2026)
+// ==================================================
+
+static HzFUN_SHARED_DEF *HzFUN_SHARED_LIST = NULL ;
+
+// ****************************************
+HzFUN_INFO_DEF *create_HzFUN_INFO(int VBOSE, double *cosPar, char *fileName) {
+
+  // Created Oct 2026
+  // Allocate and initialize HzFUN_INFO as in init_HzFUN_INFO, except
+  // that the map/grid arrays and the distance/inverse tables point 
+  // into immutable payloads shared with every other instance created
+  // for the same map file and OPT_INTERP (map payload), and for the 
+  // same map payload, COSPAR_LIST and IPREC (table payload). Identical
+  // maps are thus read once and identical tables built once per job.
+  // Returned instance has NREF=1; use retain_HzFUN_INFO for each 
+  // additional owner, and release_HzFUN_INFO when done.
+  // set_HzFUN_PRECISION and set_HzFUN_MAP_INTERP switch payloads.
+
+  HzFUN_INFO_DEF *HzFUN_INFO ;
+  char fnam[] = "create_HzFUN_INFO" ;
+
+  // ----------- BEGIN ------------
+
+  if ( VBOSE ) {  print_banner(fnam); }
+
+  HzFUN_INFO = (HzFUN_INFO_DEF*) malloc( sizeof(HzFUN_INFO_DEF) );
+  set_HzFUN_DEFAULTS(cosPar, HzFUN_INFO);
+  HzFUN_INFO->USE_SHARED = true ;
+  HzFUN_INFO->NREF       = 1 ;
+
+  if ( !IGNOREFILE(fileName) ) {
+    get_HzFUN_SHARED_MAP(VBOSE, fileName, OPT_INTERP_HzFUN_MAP_LINEAR, 
+			 HzFUN_INFO);
+  }
+  else
+    { init_HzFUN_LCDM(HzFUN_INFO); }
+
+  get_HzFUN_SHARED_TABLE(VBOSE, HzFUN_INFO);
+
+  return HzFUN_INFO ;
+
+} // end create_HzFUN_INFO
+
+
+// ****************************************
+HzFUN_INFO_DEF *retain_HzFUN_INFO(HzFUN_INFO_DEF *HzFUN_INFO) {
+  // Created Oct 2026
+  // Add owner to instance from create_HzFUN_INFO; thread safe.
+  __atomic_add_fetch(&HzFUN_INFO->NREF, 1, __ATOMIC_RELAXED);
+  return HzFUN_INFO ;
+} // end retain_HzFUN_INFO
+
+
+// ****************************************
+void release_HzFUN_INFO(HzFUN_INFO_DEF *HzFUN_INFO) {
+
+  // Created Oct 2026
+  // Remove owner of instance from create_HzFUN_INFO; last owner
+  // releases the shared payloads and frees the instance. Thread safe.
+
+  char fnam[] = "release_HzFUN_INFO" ;
+
+  if ( !HzFUN_INFO->USE_SHARED ) {
+    sprintf(c1err,"HzFUN_INFO was not created by create_HzFUN_INFO");
+    sprintf(c2err,"Use free_HzFUN_INFO instead.");
+    errmsg(SEV_FATAL, 0, fnam, c1err, c2err);
+  }
+
+  if ( __atomic_sub_fetch(&HzFUN_INFO->NREF, 1, __ATOMIC_ACQ_REL) > 0 ) 
+    { return ; }
+
+  free_HzFUN_INFO(HzFUN_INFO);
+  free(HzFUN_INFO);
+
+} // end release_HzFUN_INFO
+
+
+// ****************************************
+static double *move_HzFUN_ARENA(double *ARR, size_t N, 
+				HzFUN_ARENA_DEF *ARENA) {
+  // Created Oct 2026: copy malloc'ed ARR[N] into ARENA and free ARR
+  double *ARR_NEW = alloc_HzFUN_ARENA(N, ARENA);
+  memcpy(ARR_NEW, ARR, N*sizeof(double));
+  free(ARR);
+  return ARR_NEW ;
+} // end move_HzFUN_ARENA
+
+static size_t ndouble_HzFUN_ARENA(size_t N) {
+  // Created Oct 2026: arena size for array of N doubles
+  return ( (N + NALIGN_HzFUN_ARENA - 1) / NALIGN_HzFUN_ARENA ) * 
+    NALIGN_HzFUN_ARENA ;
+} // end ndouble_HzFUN_ARENA
+
+
+// ****************************************
+void get_HzFUN_SHARED_MAP(int VBOSE, char *fileName, int OPT_INTERP,
+			  HzFUN_INFO_DEF *HzFUN_INFO) {
+
+  // Created Oct 2026
+  // Attach map payload for fileName and OPT_INTERP to HzFUN_INFO; 
+  // the payload is read (read_HzFUN_MAP) only if no other instance
+  // holds it. Text-map arrays are moved into one arena block; a 
+  // binary map stays mmap'd, and its distance table (if any) is 
+  // rescaled to the H0 of HzFUN_INFO.
+  // Map and grid depend only on the file, except for the debug 
+  // OUT file written from COSPAR_LIST (read_HzFUN_MAP); COSPAR_LIST
+  // is then part of the key, so that each cosmology gets its own map.
+
+  HzFUN_SHARED_DEF *SHARED ;
+  HzFUN_INFO_DEF   *SRC ;
+  size_t NMAP, NGRID ;
+  int    NBYTE_KEY  = NCOSPAR_HzFUN * sizeof(double) ;
+  bool   KEY_COSPAR = is_HzFUN_MAP_OUTFILE(fileName) ;
+
+  // ----------- BEGIN ------------
+
+#ifdef _OPENMP
+#pragma omp critical(HzFUN_SHARED)
+#endif
+  {
+    for(SHARED = HzFUN_SHARED_LIST; SHARED != NULL; SHARED=SHARED->NEXT ) {
+      if ( SHARED->ITYPE == ITYPE_HzFUN_SHARED_MAP &&
+	   SHARED->OPT_INTERP_MAP == OPT_INTERP &&
+	   strcmp(SHARED->FILENAME,fileName) == 0 &&
+	   ( !KEY_COSPAR || 
+	     memcmp(SHARED->COSPAR_LIST, HzFUN_INFO->COSPAR_LIST, 
+		    NBYTE_KEY) == 0 ) ) { break; }
+    }
+
+    if ( SHARED == NULL ) {
+      SHARED = (HzFUN_SHARED_DEF*) calloc(1, sizeof(HzFUN_SHARED_DEF));
+      SRC    = &SHARED->SRC ;
+      set_HzFUN_DEFAULTS(HzFUN_INFO->COSPAR_LIST, SRC);
+      SRC->OPT_INTERP_MAP = OPT_INTERP ;
+      read_HzFUN_MAP(VBOSE, fileName, SRC);
+
+      if ( !SRC->USE_MMAP ) {
+	NMAP  = ndouble_HzFUN_ARENA(SRC->Nzbin_MAP);
+	NGRID = ndouble_HzFUN_ARENA(SRC->Nzbin_GRID);
+	init_HzFUN_ARENA(2*NMAP + 2*NGRID, &SHARED->ARENA);
+	SRC->zCMB_MAP  = 
+	  move_HzFUN_ARENA(SRC->zCMB_MAP,  SRC->Nzbin_MAP,  &SHARED->ARENA);
+	SRC->HzFUN_MAP = 
+	  move_HzFUN_ARENA(SRC->HzFUN_MAP, SRC->Nzbin_MAP,  &SHARED->ARENA);
+	SRC->Hz_GRID   = 
+	  move_HzFUN_ARENA(SRC->Hz_GRID,   SRC->Nzbin_GRID, &SHARED->ARENA);
+	SRC->dHdz_GRID = 
+	  move_HzFUN_ARENA(SRC->dHdz_GRID, SRC->Nzbin_GRID, &SHARED->ARENA);
+      }
+
+      SHARED->ITYPE          = ITYPE_HzFUN_SHARED_MAP ;
+      SHARED->FILENAME       = SRC->FILENAME ;
+      SHARED->OPT_INTERP_MAP = OPT_INTERP ;
+      if ( KEY_COSPAR ) 
+	{ memcpy(SHARED->COSPAR_LIST, HzFUN_INFO->COSPAR_LIST, NBYTE_KEY); }
+      SHARED->NEXT           = HzFUN_SHARED_LIST ;
+      HzFUN_SHARED_LIST      = SHARED ;
+    }
+    SHARED->NREF++ ;
+  }
+
+  SRC = &SHARED->SRC ;
+  HzFUN_INFO->SHARED_MAP     = SHARED ;
+  HzFUN_INFO->USE_MAP        = true ;
+  HzFUN_INFO->FILENAME       = SRC->FILENAME ;
+  HzFUN_INFO->OPT_INTERP_MAP = SRC->OPT_INTERP_MAP ;
+  HzFUN_INFO->Nzbin_MAP      = SRC->Nzbin_MAP ;
+  HzFUN_INFO->zCMB_MAP       = SRC->zCMB_MAP ;
+  HzFUN_INFO->HzFUN_MAP      = SRC->HzFUN_MAP ;
+  HzFUN_INFO->Nzbin_GRID     = SRC->Nzbin_GRID ;
+  HzFUN_INFO->dz_GRID        = SRC->dz_GRID ;
+  HzFUN_INFO->zmax_GRID      = SRC->zmax_GRID ;
+  HzFUN_INFO->Hz_GRID        = SRC->Hz_GRID ;
+  HzFUN_INFO->dHdz_GRID      = SRC->dHdz_GRID ;
+  HzFUN_INFO->USE_MMAP       = SRC->USE_MMAP ;
+  HzFUN_INFO->MMAP_ADDR      = SRC->MMAP_ADDR ;
+  HzFUN_INFO->MMAP_SIZE      = SRC->MMAP_SIZE ;
+  HzFUN_INFO->MMAP_TABLE     = false ;
+
+  if ( SRC->MMAP_TABLE ) {
+    HzFUN_INFO->MMAP_TABLE  = true ;
+    HzFUN_INFO->Nzbin_TABLE = SRC->Nzbin_TABLE ;
+    HzFUN_INFO->dz_TABLE    = SRC->dz_TABLE ;
+    HzFUN_INFO->zmax_TABLE  = SRC->zmax_TABLE ;
+    HzFUN_INFO->DC_TABLE    = SRC->DC_TABLE ;
+    HzFUN_INFO->EINV_TABLE  = SRC->EINV_TABLE ;
+    HzFUN_INFO->H0REF_TABLE = SRC->H0REF_TABLE ;
+    set_HzFUN_TABLE_SCALE(HzFUN_INFO);
+  }
+
+} // end get_HzFUN_SHARED_MAP
+
+
+// ****************************************
+void get_HzFUN_SHARED_TABLE(int VBOSE, HzFUN_INFO_DEF *HzFUN_INFO) {
+
+  // Created Oct 2026
+  // Attach distance and inverse tables to HzFUN_INFO from the table
+  // payload for (SHARED_MAP, table key, IPREC); the payload is 
+  // built (init_HzFUN_TABLE) only if no other instance holds it.
+  // The key ignores H0 (see get_HzFUN_TABLE_KEY), so that instances
+  // that differ only in H0 share the tables.
+  // No payload for REFERENCE tier (no tables), nor for a distance
+  // table from a binary map file (only the inverse table is built).
+
+  HzFUN_SHARED_DEF *SHARED ;
+  HzFUN_INFO_DEF   *SRC ;
+  size_t NTABLE, NMUINV ;
+  int    NBYTE_KEY = NCOSPAR_HzFUN * sizeof(double) ;
+  double KEY[NCOSPAR_HzFUN] ;
+
+  // ----------- BEGIN ------------
+
+  HzFUN_INFO->SHARED_TABLE = NULL ;
+  HzFUN_INFO->USE_TABLE    = false ;
+  HzFUN_INFO->Nbin_MUINV   = 0 ;
+
+  if ( HzFUN_INFO->MMAP_TABLE ) {
+    HzFUN_INFO->USE_TABLE = ( HzFUN_INFO->IPREC != IPREC_HzFUN_REFERENCE );
+    init_MUINV_TABLE(VBOSE, HzFUN_INFO);
+    return ;
+  }
+  if ( HzFUN_INFO->IPREC == IPREC_HzFUN_REFERENCE ) { return ; }
+
+  get_HzFUN_TABLE_KEY(HzFUN_INFO, KEY);
+
+#ifdef _OPENMP
+#pragma omp critical(HzFUN_SHARED)
+#endif
+  {
+    for(SHARED = HzFUN_SHARED_LIST; SHARED != NULL; SHARED=SHARED->NEXT ) {
+      if ( SHARED->ITYPE == ITYPE_HzFUN_SHARED_TABLE &&
+	   SHARED->MAP   == HzFUN_INFO->SHARED_MAP &&
+	   SHARED->IPREC == HzFUN_INFO->IPREC &&
+	   memcmp(SHARED->COSPAR_LIST, KEY, NBYTE_KEY) == 0 )
+	{ break; }
+    }
+
+    if ( SHARED == NULL ) {
+      SHARED  = (HzFUN_SHARED_DEF*) calloc(1, sizeof(HzFUN_SHARED_DEF));
+      SRC     = &SHARED->SRC ;
+      *SRC    = *HzFUN_INFO ;
+      init_HzFUN_TABLE(VBOSE, SRC);
+
+      NTABLE = NMUINV = 0 ;
+      if ( SRC->USE_TABLE ) 
+	{ NTABLE = ndouble_HzFUN_ARENA(SRC->Nzbin_TABLE); }
+      if ( SRC->Nbin_MUINV > 0 ) 
+	{ NMUINV = ndouble_HzFUN_ARENA(SRC->Nbin_MUINV); }
+      init_HzFUN_ARENA(2*NTABLE + 2*NMUINV, &SHARED->ARENA);
+      if ( SRC->USE_TABLE ) {
+	SRC->DC_TABLE    = 
+	  move_HzFUN_ARENA(SRC->DC_TABLE,   SRC->Nzbin_TABLE, &SHARED->ARENA);
+	SRC->EINV_TABLE  = 
+	  move_HzFUN_ARENA(SRC->EINV_TABLE, SRC->Nzbin_TABLE, &SHARED->ARENA);
+      }
+      if ( SRC->Nbin_MUINV > 0 ) {
+	SRC->zCMB_MUINV  = 
+	  move_HzFUN_ARENA(SRC->zCMB_MUINV,  SRC->Nbin_MUINV, &SHARED->ARENA);
+	SRC->dzdmu_MUINV = 
+	  move_HzFUN_ARENA(SRC->dzdmu_MUINV, SRC->Nbin_MUINV, &SHARED->ARENA);
+      }
+
+      SHARED->ITYPE = ITYPE_HzFUN_SHARED_TABLE ;
+      SHARED->MAP   = HzFUN_INFO->SHARED_MAP ;
+      SHARED->IPREC = HzFUN_INFO->IPREC ;
+      memcpy(SHARED->COSPAR_LIST, KEY, NBYTE_KEY);
+      SHARED->NEXT      = HzFUN_SHARED_LIST ;
+      HzFUN_SHARED_LIST = SHARED ;
+    }
+    SHARED->NREF++ ;
+  }
+
+  SRC = &SHARED->SRC ;
+  HzFUN_INFO->SHARED_TABLE = SHARED ;
+  HzFUN_INFO->USE_TABLE    = SRC->USE_TABLE ;
+  HzFUN_INFO->Nzbin_TABLE  = SRC->Nzbin_TABLE ;
+  HzFUN_INFO->zmax_TABLE   = SRC->zmax_TABLE ;
+  HzFUN_INFO->dz_TABLE     = SRC->dz_TABLE ;
+  HzFUN_INFO->DC_TABLE     = SRC->DC_TABLE ;
+  HzFUN_INFO->EINV_TABLE   = SRC->EINV_TABLE ;
+  HzFUN_INFO->Nbin_MUINV   = SRC->Nbin_MUINV ;
+  HzFUN_INFO->mumin_MUINV  = SRC->mumin_MUINV ;
+  HzFUN_INFO->mumax_MUINV  = SRC->mumax_MUINV ;
+  HzFUN_INFO->dmu_MUINV    = SRC->dmu_MUINV ;
+  HzFUN_INFO->zCMB_MUINV   = SRC->zCMB_MUINV ;
+  HzFUN_INFO->dzdmu_MUINV  = SRC->dzdmu_MUINV ;
+  HzFUN_INFO->H0REF_TABLE  = SRC->H0REF_TABLE ;
+  set_HzFUN_TABLE_SCALE(HzFUN_INFO);
+
+} // end get_HzFUN_SHARED_TABLE
+
+
+// ****************************************
+void release_HzFUN_SHARED(HzFUN_SHARED_DEF *SHARED) {
+
+  // Created Oct 2026
+  // Drop one reference to payload; last reference unlinks and frees
+  // it (arena block, FILENAME, and mmap of binary map).
+  // A table payload is keyed by its map payload, and is always 
+  // released before the map payload of the same instance.
+
+  HzFUN_SHARED_DEF **PTR ;
+  bool FREE = false ;
+
+#ifdef _OPENMP
+#pragma omp critical(HzFUN_SHARED)
+#endif
+  {
+    SHARED->NREF-- ;
+    if ( SHARED->NREF == 0 ) {
+      for(PTR = &HzFUN_SHARED_LIST; *PTR != NULL; PTR = &(*PTR)->NEXT ) 
+	{ if ( *PTR == SHARED ) { *PTR = SHARED->NEXT;  break; } }
+      FREE = true ;
+    }
+  }
+
+  if ( !FREE ) { return ; }
+
+  if ( SHARED->ITYPE == ITYPE_HzFUN_SHARED_MAP ) {
+    if ( SHARED->SRC.USE_MMAP ) 
+      { munmap(SHARED->SRC.MMAP_ADDR, SHARED->SRC.MMAP_SIZE); }
+    free(SHARED->FILENAME);
+  }
+  free_HzFUN_ARENA(&SHARED->ARENA);
+  free(SHARED);
+
+} // end release_HzFUN_SHARED
+
+
+// ****************************************
+void get_HzFUN_SHARED_STATS(int *NPAYLOAD, size_t *NBYTE) {
+  // Created Oct 2026
+  // Return number of live shared payloads and their memory (arena
+  // blocks plus mapped files).
+  HzFUN_SHARED_DEF *SHARED ;
+  *NPAYLOAD = 0;  *NBYTE = 0 ;
+#ifdef _OPENMP
+#pragma omp critical(HzFUN_SHARED)
+#endif
+  {
+    for(SHARED = HzFUN_SHARED_LIST; SHARED != NULL; SHARED=SHARED->NEXT ) {
+      (*NPAYLOAD)++ ;
+      *NBYTE += SHARED->ARENA.NDOUBLE * sizeof(double) ;
+      if ( SHARED->SRC.USE_MMAP && SHARED->ITYPE == ITYPE_HzFUN_SHARED_MAP )
+	{ *NBYTE += SHARED->SRC.MMAP_SIZE ; }
+    }
+  }
+} // end get_HzFUN_SHARED_STATS
+
+
+// ****************************************
+void init_HzFUN_ARENA(size_t NDOUBLE, HzFUN_ARENA_DEF *ARENA) {
+
+  // Created Oct 2026
+  // Allocate one 64-byte aligned block of NDOUBLE doubles; arrays
+  // are then carved out with alloc_HzFUN_ARENA. 
+
+  void *BUF = NULL ;
+  char fnam[] = "init_HzFUN_ARENA" ;
+
+  ARENA->BUF     = NULL ;
+  ARENA->NDOUBLE = NDOUBLE ;
+  ARENA->NUSED   = 0 ;
+  if ( NDOUBLE == 0 ) { return ; }
+
+  if ( posix_memalign(&BUF, 64, NDOUBLE*sizeof(double)) != 0 ) {
+    sprintf(c1err,"Unable to allocate %ld doubles", (long)NDOUBLE);
+    sprintf(c2err,"for shared HzFUN payload");
+    errmsg(SEV_FATAL, 0, fnam, c1err, c2err);
+  }
+  ARENA->BUF = (double*)BUF ;
+
+} // end init_HzFUN_ARENA
+
+
+// ****************************************
+double *alloc_HzFUN_ARENA(size_t N, HzFUN_ARENA_DEF *ARENA) {
+
+  // Created Oct 2026
+  // Return next N doubles of ARENA; next array starts at a 
+  // multiple of NALIGN_HzFUN_ARENA doubles.
+
+  double *ARR ;
+  size_t NALLOC = ndouble_HzFUN_ARENA(N);
+  char fnam[] = "alloc_HzFUN_ARENA" ;
+
+  if ( ARENA->NUSED + N > ARENA->NDOUBLE ) {
+    sprintf(c1err,"Request %ld doubles, but only %ld of %ld left", 
+	    (long)N, (long)(ARENA->NDOUBLE-ARENA->NUSED), 
+	    (long)ARENA->NDOUBLE);
+    sprintf(c2err,"Check arena size for shared HzFUN payload");
+    errmsg(SEV_FATAL, 0, fnam, c1err, c2err);
+  }
+
+  ARR = ARENA->BUF + ARENA->NUSED ;
+  ARENA->NUSED += NALLOC ;
+  if ( ARENA->NUSED > ARENA->NDOUBLE ) { ARENA->NUSED = ARENA->NDOUBLE; }
+  return ARR ;
+
+} // end alloc_HzFUN_ARENA
+
+
+// ****************************************
+void free_HzFUN_ARENA(HzFUN_ARENA_DEF *ARENA) {
+  // Created Oct 2026
+  if ( ARENA->BUF != NULL ) { free(ARENA->BUF); }
+  ARENA->BUF = NULL ;  ARENA->NDOUBLE = ARENA->NUSED = 0 ;
+} // end free_HzFUN_ARENA
+
+
+// ****************************************
+unsigned long long checksum_FNV1a(unsigned long long HASH, 
+				  const void *DATA, size_t NBYTE) {
+  // Created Oct 2026
+  // 64-bit FNV-1a hash of NBYTE bytes; start with HASH=0 to use 
+  // the standard offset basis, or pass previous HASH to continue.
+  const unsigned char *c = (const unsigned char*)DATA ;
+  size_t i;
+  if ( HASH == 0 ) { HASH = 14695981039346656037ULL ; }
+  for(i=0; i < NBYTE; i++ ) 
+    { HASH ^= (unsigned long long)c[i];  HASH *= 1099511628211ULL ; }
+  return HASH ;
+} // end checksum_FNV1a
+
+
+// ****************************************
+bool is_HzFUN_BINARY(char *fileName) {
+  // Created Oct 2026: return true if file starts with binary magic key
+  char MAGIC[8] ;
+  FILE *fp = fopen(fileName,"rb");
+  bool IS_BINARY = false ;
+  if ( !fp ) { return false ; }
+  if ( fread(MAGIC, 1, 8, fp) == 8 ) 
+    { IS_BINARY = ( strncmp(MAGIC,MAGIC_HzFUN_BINARY,8) == 0 ) ; }
+  fclose(fp);
+  return IS_BINARY ;
+} // end is_HzFUN_BINARY
+
+
+// ****************************************
+void read_HzFUN_BINARY(int VBOSE, char *fileName, HzFUN_INFO_DEF *HzFUN_INFO) {
+
+  // Created Oct 2026
+  // mmap binary H(z) map read-only and point map, grid and (optional)
+  // distance-table arrays into the mapped file; nothing is copied,
+  // and pages are shared among processes reading the same file.
+  // The stored distance table is in units of c/H0 for the H0 in the
+  // header, and is rescaled to COSPAR_LIST (Oct 2026: was used only
+  // for matching H0). Header and checksum are verified.
+
+  HzFUN_BINARY_HEADER_DEF *HEAD ;
+  struct stat st ;
+  char   *ADDR ;
+  double *DATA ;
+  size_t NDATA, NBYTE_DATA ;
+  unsigned long long CHECKSUM ;
+  int    fd, Nmap, Ngrid, Ntable ;
+  char   fnam[] = "read_HzFUN_BINARY" ;
+
+  // ------------ BEGIN -------------
+
+  if ( VBOSE ) {
+    printf("   Read binary H(z) map from: %s \n", fileName ); 
+    fflush(stdout);
+  }
+
+  fd = open(fileName, O_RDONLY);
+  if ( fd < 0 || fstat(fd,&st) != 0 ) {
+    sprintf(c1err,"Unable to open binary H(z) map");
+    sprintf(c2err,"%.150s", fileName);
+    errmsg(SEV_FATAL, 0, fnam, c1err, c2err);
+  }
+
+  if ( st.st_size < NBYTE_HEADER_HzFUN_BINARY ) {
+    sprintf(c1err,"File size (%ld bytes) is smaller than header",
+	    (long)st.st_size);
+    sprintf(c2err,"Check binary H(z) map %.150s", fileName);
+    errmsg(SEV_FATAL, 0, fnam, c1err, c2err);
+  }
+
+  ADDR = (char*) mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if ( ADDR == MAP_FAILED ) {
+    sprintf(c1err,"mmap failed for binary H(z) map");
+    sprintf(c2err,"%.150s", fileName);
+    errmsg(SEV_FATAL, 0, fnam, c1err, c2err);
+  }
+
+  HEAD   = (HzFUN_BINARY_HEADER_DEF*) ADDR ;
+  Nmap   = HEAD->Nzbin_MAP ;
+  Ngrid  = HEAD->Nzbin_GRID ;
+  Ntable = HEAD->Nzbin_TABLE ;
+  NDATA  = 2*(size_t)Nmap + 2*(size_t)Ngrid + 2*(size_t)Ntable ;
+  NBYTE_DATA = NDATA * sizeof(double);
+
+  if ( HEAD->VERSION  != VERSION_HzFUN_BINARY ||
+       HEAD->GRIDTYPE != GRIDTYPE_HzFUN_UNIFORM_Z ) {
+    sprintf(c1err,"Unsupported VERSION=%d or GRIDTYPE=%d", 
+	    HEAD->VERSION, HEAD->GRIDTYPE);
+    sprintf(c2err,"Expect VERSION=%d, GRIDTYPE=%d for %.150s",
+	    VERSION_HzFUN_BINARY, GRIDTYPE_HzFUN_UNIFORM_Z, fileName);
+    errmsg(SEV_FATAL, 0, fnam, c1err, c2err);
+  }
+
+  if ( (size_t)st.st_size != NBYTE_HEADER_HzFUN_BINARY + NBYTE_DATA ) {
+    sprintf(c1err,"File size = %ld bytes, but header expects %ld",
+	    (long)st.st_size, (long)(NBYTE_HEADER_HzFUN_BINARY+NBYTE_DATA));
+    sprintf(c2err,"Check binary H(z) map %.150s", fileName);
+    errmsg(SEV_FATAL, 0, fnam, c1err, c2err);
+  }
+
+  DATA     = (double*)(ADDR + NBYTE_HEADER_HzFUN_BINARY) ;
+  CHECKSUM = checksum_FNV1a(0, DATA, NBYTE_DATA);
+  if ( CHECKSUM != HEAD->CHECKSUM ) {
+    sprintf(c1err,"CHECKSUM=%llx, but header CHECKSUM=%llx", 
+	    CHECKSUM, HEAD->CHECKSUM);
+    sprintf(c2err,"Binary H(z) map is corrupt: %.150s", fileName);
+    errmsg(SEV_FATAL, 0, fnam, c1err, c2err);
+  }
+
+  HzFUN_INFO->USE_MMAP       = true ;
+  HzFUN_INFO->MMAP_ADDR      = ADDR ;
+  HzFUN_INFO->MMAP_SIZE      = st.st_size ;
+  HzFUN_INFO->OPT_INTERP_MAP = HEAD->OPT_INTERP_MAP ;
+  HzFUN_INFO->Nzbin_MAP      = Nmap ;
+  HzFUN_INFO->zCMB_MAP       = DATA ;             DATA += Nmap ;
+  HzFUN_INFO->HzFUN_MAP      = DATA ;             DATA += Nmap ;
+  HzFUN_INFO->Nzbin_GRID     = Ngrid ;
+  HzFUN_INFO->dz_GRID        = HEAD->dz_GRID ;
+  HzFUN_INFO->zmax_GRID      = HEAD->zmax_GRID ;
+  HzFUN_INFO->Hz_GRID        = DATA ;             DATA += Ngrid ;
+  HzFUN_INFO->dHdz_GRID      = DATA ;             DATA += Ngrid ;
+
+  if ( Ntable > 0 ) {
+    HzFUN_INFO->Nzbin_TABLE = Ntable ;
+    HzFUN_INFO->dz_TABLE    = HEAD->dz_TABLE ;
+    HzFUN_INFO->zmax_TABLE  = HEAD->zmax_TABLE ;
+    HzFUN_INFO->DC_TABLE    = DATA ;              DATA += Ntable ;
+    HzFUN_INFO->EINV_TABLE  = DATA ;
+    HzFUN_INFO->USE_TABLE   = true ;
+    HzFUN_INFO->MMAP_TABLE  = true ;
+    HzFUN_INFO->H0REF_TABLE = HEAD->COSPAR_LIST[ICOSPAR_HzFUN_H0] ;
+    set_HzFUN_TABLE_SCALE(HzFUN_INFO);
+  }
+
+  if ( VBOSE ) {
+    printf("\t Found %d redshift bins from %f to %f (%d grid nodes%s)\n",
+	   Nmap, HzFUN_INFO->zCMB_MAP[0], HzFUN_INFO->zCMB_MAP[Nmap-1], 
+	   Ngrid, HzFUN_INFO->MMAP_TABLE ? ", distance table" : "" );
+    fflush(stdout);
+  }
+
+  return ;
+
+} // end read_HzFUN_BINARY
+
+
+// ****************************************
+void write_HzFUN_BINARY(char *fileName, bool WRITE_TABLE, 
+			const HzFUN_INFO_DEF *HzFUN_INFO) {
+
+  // Created Oct 2026
+  // Write binary H(z) map from HzFUN_INFO that was initialized from
+  // a text map. If WRITE_TABLE=true, also write the cumulative
+  // distance table (DC_TABLE, EINV_TABLE) so that readers skip 
+  // the table integration. The file is written to a temporary name
+  // and renamed, so that readers never see a partial file.
+
+  HzFUN_BINARY_HEADER_DEF HEAD ;
+  char   HEADER[NBYTE_HEADER_HzFUN_BINARY], tmpFile[MXPATHLEN+20] ;
+  int    Nmap   = HzFUN_INFO->Nzbin_MAP ;
+  int    Ngrid  = HzFUN_INFO->Nzbin_GRID ;
+  int    Ntable = 0, ipar ;
+  unsigned long long CHECKSUM ;
+  FILE  *fp ;
+  char   fnam[] = "write_HzFUN_BINARY" ;
+
+  // ------------ BEGIN -------------
+
+  if ( !HzFUN_INFO->USE_MAP || Ngrid < 2 ) {
+    sprintf(c1err,"HzFUN_INFO is not initialized from H(z) map.");
+    sprintf(c2err,"Cannot write binary map %.150s", fileName);
+    errmsg(SEV_FATAL, 0, fnam, c1err, c2err);
+  }
+  if ( WRITE_TABLE && HzFUN_INFO->USE_TABLE ) 
+    { Ntable = HzFUN_INFO->Nzbin_TABLE ; }
+
+  memset(&HEAD, 0, sizeof(HzFUN_BINARY_HEADER_DEF));
+  strncpy(HEAD.MAGIC, MAGIC_HzFUN_BINARY, 8);
+  HEAD.VERSION        = VERSION_HzFUN_BINARY ;
+  HEAD.GRIDTYPE       = GRIDTYPE_HzFUN_UNIFORM_Z ;
+  HEAD.OPT_INTERP_MAP = HzFUN_INFO->OPT_INTERP_MAP ;
+  HEAD.Nzbin_MAP      = Nmap ;
+  HEAD.Nzbin_GRID     = Ngrid ;
+  HEAD.Nzbin_TABLE    = Ntable ;
+  for(ipar=0; ipar < NCOSPAR_HzFUN; ipar++ ) 
+    { HEAD.COSPAR_LIST[ipar] = HzFUN_INFO->COSPAR_LIST[ipar]; }
+  HEAD.dz_GRID   = HzFUN_INFO->dz_GRID ;
+  HEAD.zmax_GRID = HzFUN_INFO->zmax_GRID ;
+  if ( Ntable > 0 ) {
+    HEAD.dz_TABLE   = HzFUN_INFO->dz_TABLE ;
+    HEAD.zmax_TABLE = HzFUN_INFO->zmax_TABLE ;
+    HEAD.COSPAR_LIST[ICOSPAR_HzFUN_H0] = HzFUN_INFO->H0REF_TABLE ;
+  }
+
+  CHECKSUM = checksum_FNV1a(0,        HzFUN_INFO->zCMB_MAP,  Nmap *8);
+  CHECKSUM = checksum_FNV1a(CHECKSUM, HzFUN_INFO->HzFUN_MAP, Nmap *8);
+  CHECKSUM = checksum_FNV1a(CHECKSUM, HzFUN_INFO->Hz_GRID,   Ngrid*8);
+  CHECKSUM = checksum_FNV1a(CHECKSUM, HzFUN_INFO->dHdz_GRID, Ngrid*8);
+  if ( Ntable > 0 ) {
+    CHECKSUM = checksum_FNV1a(CHECKSUM, HzFUN_INFO->DC_TABLE,   Ntable*8);
+    CHECKSUM = checksum_FNV1a(CHECKSUM, HzFUN_INFO->EINV_TABLE, Ntable*8);
+  }
+  HEAD.CHECKSUM = CHECKSUM ;
+
+  memset(HEADER, 0, NBYTE_HEADER_HzFUN_BINARY);
+  memcpy(HEADER, &HEAD, sizeof(HzFUN_BINARY_HEADER_DEF));
+
+  sprintf(tmpFile, "%s.tmp%d", fileName, (int)getpid() );
+  fp = fopen(tmpFile,"wb");
+  if ( !fp ) {
+    sprintf(c1err,"Unable to open '%.150s' in write-binary mode", tmpFile);
+    sprintf(c2err,"Check permissions.") ;
+    errmsg(SEV_FATAL, 0, fnam, c1err, c2err);
+  }
+
+  fwrite(HEADER, 1, NBYTE_HEADER_HzFUN_BINARY, fp);
+  fwrite(HzFUN_INFO->zCMB_MAP,  sizeof(double), Nmap,  fp);
+  fwrite(HzFUN_INFO->HzFUN_MAP, sizeof(double), Nmap,  fp);
+  fwrite(HzFUN_INFO->Hz_GRID,   sizeof(double), Ngrid, fp);
+  fwrite(HzFUN_INFO->dHdz_GRID, sizeof(double), Ngrid, fp);
+  if ( Ntable > 0 ) {
+    fwrite(HzFUN_INFO->DC_TABLE,   sizeof(double), Ntable, fp);
+    fwrite(HzFUN_INFO->EINV_TABLE, sizeof(double), Ntable, fp);
+  }
+
+  if ( fclose(fp) != 0 || rename(tmpFile,fileName) != 0 ) {
+    sprintf(c1err,"Unable to write binary H(z) map");
+    sprintf(c2err,"%.150s", fileName);
+    errmsg(SEV_FATAL, 0, fnam, c1err, c2err);
+  }
+
+  printf("   Wrote binary H(z) map to %s (%d map rows, %d grid nodes, "
+	 "%d table nodes)\n", fileName, Nmap, Ngrid, Ntable);
+  fflush(stdout);
+
+} // end write_HzFUN_BINARY
+
+
+// ****************************************
+void convert_HzFUN_MAP(char *textFile, char *binFile, double *cosPar, 
+		       int OPT_INTERP, bool WRITE_TABLE) {
+
+  // Created Oct 2026
+  // Convert 2-column text map of H(z) into binary map (see 
+  // write_HzFUN_BINARY). cosPar is stored as documentation, and its
+  // H0 is used for the optional distance table. OPT_INTERP is
+  // OPT_INTERP_HzFUN_MAP_XXX, and is fixed in the binary file.
+
+  HzFUN_INFO_DEF HzFUN_INFO ;
+
+  init_HzFUN_INFO(0, cosPar, textFile, &HzFUN_INFO);
+  set_HzFUN_MAP_INTERP(OPT_INTERP, &HzFUN_INFO);
+  write_HzFUN_BINARY(binFile, WRITE_TABLE, &HzFUN_INFO);
+  free_HzFUN_INFO(&HzFUN_INFO);
+
+} // end convert_HzFUN_MAP
+
+
+// ==================================================
+//   on-disk cache of distance and inverse tables (Oct 2026)
+// ==================================================
+
+static char HzFUN_TABLE_CACHE_DIR[MXPATHLEN] ;
+static bool HzFUN_TABLE_CACHE_INIT = false ;
+
+// ****************************************
+void set_HzFUN_TABLE_CACHE(char *dirName) {
+
+  // Created Oct 2026
+  // Set directory of table cache files; dirName=NONE or blank
+  // disables the cache. Without this call, the directory is taken
+  // from environment variable ENV_HzFUN_TABLE_CACHE (if set).
+
+#ifdef _OPENMP
+#pragma omp critical(HzFUN_TABLE_CACHE)
+#endif
+  {
+    HzFUN_TABLE_CACHE_DIR[0] = 0 ;
+    if ( !IGNOREFILE(dirName) )
+      { snprintf(HzFUN_TABLE_CACHE_DIR, MXPATHLEN, "%s", dirName); }
+    HzFUN_TABLE_CACHE_INIT = true ;
+  }
+
+} // end set_HzFUN_TABLE_CACHE
+
+static bool get_HzFUN_TABLE_CACHE_FILE(const HzFUN_INFO_DEF *HzFUN_INFO,
+				       unsigned long long *KEY,
+				       char *cacheFile) {
+  // Created Oct 2026
+  // Return false if cache is disabled; else return true and load
+  // KEY and name of cache file for the tables of HzFUN_INFO.
+  char *ENV ;
+#ifdef _OPENMP
+#pragma omp critical(HzFUN_TABLE_CACHE)
+#endif
+  {
+    if ( !HzFUN_TABLE_CACHE_INIT ) {
+      ENV = getenv(ENV_HzFUN_TABLE_CACHE);
+      HzFUN_TABLE_CACHE_DIR[0] = 0 ;
+      if ( ENV != NULL && !IGNOREFILE(ENV) )
+	{ snprintf(HzFUN_TABLE_CACHE_DIR, MXPATHLEN, "%s", ENV); }
+      HzFUN_TABLE_CACHE_INIT = true ;
+    }
+  }
+  if ( HzFUN_TABLE_CACHE_DIR[0] == 0 ) { return false ; }
+  *KEY = get_HzFUN_TABLE_CACHE_KEY(HzFUN_INFO);
+  snprintf(cacheFile, MXPATHLEN+40, "%s/HzFUN_TABLE_%016llx.bin",
+	   HzFUN_TABLE_CACHE_DIR, *KEY );
+  return true ;
+} // end get_HzFUN_TABLE_CACHE_FILE
+
+
+// ****************************************
+unsigned long long get_HzFUN_TABLE_CACHE_KEY(const HzFUN_INFO_DEF 
+					     *HzFUN_INFO) {
+
+  // Created Oct 2026
+  // Return hash of everything that the distance and inverse tables
+  // depend on: table key (get_HzFUN_TABLE_KEY; H0 is not included
+  // since tables are rescaled by set_HzFUN_TABLE_SCALE), IPREC,
+  // cache VERSION, table binsizes, and for a map, OPT_INTERP_MAP and
+  // the map contents (so that a renamed or edited map file is safe).
+
+  double KEYPAR[NCOSPAR_HzFUN+10] ;
+  int    NPAR = NCOSPAR_HzFUN ;
+  int    Nmap = HzFUN_INFO->Nzbin_MAP ;
+  unsigned long long HASH ;
+
+  get_HzFUN_TABLE_KEY(HzFUN_INFO, KEYPAR);
+  KEYPAR[NPAR++] = (double)VERSION_HzFUN_TABLE_CACHE ;
+  KEYPAR[NPAR++] = (double)HzFUN_INFO->IPREC ;
+  KEYPAR[NPAR++] = ZMAX_HzFUN_TABLE ;
+  KEYPAR[NPAR++] = DZBIN_HzFUN_TABLE ;
+  KEYPAR[NPAR++] = DZBIN_HzFUN_TABLE_FAST ;
+  KEYPAR[NPAR++] = ZMIN_MUINV_TABLE ;
+  KEYPAR[NPAR++] = DMUBIN_MUINV_TABLE ;
+  KEYPAR[NPAR++] = DMUBIN_MUINV_TABLE_FAST ;
+  KEYPAR[NPAR++] = (double)HzFUN_INFO->USE_MAP ;
+  KEYPAR[NPAR++] =
+    HzFUN_INFO->USE_MAP ? (double)HzFUN_INFO->OPT_INTERP_MAP : 0.0 ;
+
+  HASH = checksum_FNV1a(0, KEYPAR, NPAR*sizeof(double));
+  if ( HzFUN_INFO->USE_MAP ) {
+    HASH = checksum_FNV1a(HASH, HzFUN_INFO->zCMB_MAP,  Nmap*sizeof(double));
+    HASH = checksum_FNV1a(HASH, HzFUN_INFO->HzFUN_MAP, Nmap*sizeof(double));
+  }
+  return HASH ;
+
+} // end get_HzFUN_TABLE_CACHE_KEY
+
+
+// ****************************************
+bool read_HzFUN_TABLE_CACHE(int VBOSE, HzFUN_INFO_DEF *HzFUN_INFO) {
+
+  // Created Oct 2026
+  // If table cache is enabled and holds a valid file for HzFUN_INFO,
+  // mmap it read-only, load distance and inverse tables, and return
+  // true. Return false if there is no such file, or if the file is
+  // invalid (wrong magic, version or key, bad size or checksum); the
+  // caller then builds the tables and overwrites the file.
+  // Tables are copied out of the mapping so that HzFUN_INFO owns its
+  // arrays exactly as after init_HzFUN_TABLE (~50 kB).
+  // Thread safe (no global messages).
+
+  HzFUN_TABLE_CACHE_HEADER_DEF *HEAD ;
+  struct stat st ;
+  char   cacheFile[MXPATHLEN+40], *ADDR, *REASON = NULL ;
+  double *DATA ;
+  size_t NBYTE_DATA = 0, Nt = 0, Nmu = 0 ;
+  unsigned long long KEY ;
+  int    fd ;
+
+  // ----------- BEGIN ------------
+
+  if ( !get_HzFUN_TABLE_CACHE_FILE(HzFUN_INFO, &KEY, cacheFile) )
+    { return false ; }
+
+  fd = open(cacheFile, O_RDONLY);
+  if ( fd < 0 ) { return false ; }      // not cached yet
+  if ( fstat(fd,&st) != 0 || st.st_size < NBYTE_HEADER_HzFUN_TABLE_CACHE )
+    { close(fd);  REASON = "file too small" ;  goto INVALID ; }
+
+  ADDR = (char*) mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if ( ADDR == MAP_FAILED ) { REASON = "mmap failed" ;  goto INVALID ; }
+
+  HEAD = (HzFUN_TABLE_CACHE_HEADER_DEF*) ADDR ;
+  DATA = (double*)(ADDR + NBYTE_HEADER_HzFUN_TABLE_CACHE) ;
+  if ( strncmp(HEAD->MAGIC, MAGIC_HzFUN_TABLE_CACHE, 8) != 0 ||
+       HEAD->VERSION != VERSION_HzFUN_TABLE_CACHE )
+    { REASON = "wrong magic key or version" ; }
+  else if ( HEAD->KEY   != KEY ||
+	    HEAD->IPREC != HzFUN_INFO->IPREC )
+    { REASON = "wrong key" ; }
+  else if ( HEAD->Nzbin_TABLE < 2 || HEAD->Nbin_MUINV < 0 )
+    { REASON = "invalid table size" ; }
+  else {
+    Nt  = HEAD->Nzbin_TABLE ;
+    Nmu = HEAD->Nbin_MUINV ;
+    NBYTE_DATA = (2*Nt + 2*Nmu) * sizeof(double) ;
+    if ( (size_t)st.st_size != NBYTE_HEADER_HzFUN_TABLE_CACHE + NBYTE_DATA )
+      { REASON = "file size does not match header" ; }
+    else if ( checksum_FNV1a(0, DATA, NBYTE_DATA) != HEAD->CHECKSUM )
+      { REASON = "bad checksum" ; }
+  }
+  if ( REASON != NULL )
+    { munmap(ADDR, st.st_size);  goto INVALID ; }
+
+  HzFUN_INFO->DC_TABLE   = (double*) malloc(Nt*sizeof(double));
+  HzFUN_INFO->EINV_TABLE = (double*) malloc(Nt*sizeof(double));
+  memcpy(HzFUN_INFO->DC_TABLE,   DATA, Nt*sizeof(double));  DATA += Nt ;
+  memcpy(HzFUN_INFO->EINV_TABLE, DATA, Nt*sizeof(double));  DATA += Nt ;
+  HzFUN_INFO->Nzbin_TABLE = Nt ;
+  HzFUN_INFO->dz_TABLE    = HEAD->dz_TABLE ;
+  HzFUN_INFO->zmax_TABLE  = HEAD->zmax_TABLE ;
+  HzFUN_INFO->USE_TABLE   = true ;
+
+  HzFUN_INFO->Nbin_MUINV  = Nmu ;
+  if ( Nmu > 0 ) {
+    HzFUN_INFO->zCMB_MUINV  = (double*) malloc(Nmu*sizeof(double));
+    HzFUN_INFO->dzdmu_MUINV = (double*) malloc(Nmu*sizeof(double));
+    memcpy(HzFUN_INFO->zCMB_MUINV,  DATA, Nmu*sizeof(double)); DATA += Nmu;
+    memcpy(HzFUN_INFO->dzdmu_MUINV, DATA, Nmu*sizeof(double));
+    HzFUN_INFO->mumin_MUINV = HEAD->mumin_MUINV ;
+    HzFUN_INFO->mumax_MUINV = HEAD->mumax_MUINV ;
+    HzFUN_INFO->dmu_MUINV   = HEAD->dmu_MUINV ;
+  }
+
+  HzFUN_INFO->H0REF_TABLE = HEAD->H0REF_TABLE ;
+  set_HzFUN_TABLE_SCALE(HzFUN_INFO);
+  munmap(ADDR, st.st_size);
+
+  if ( VBOSE ) {
+    printf("\t Read distance tables (%d z-nodes, %d MU-nodes) from\n"
+	   "\t   %s\n", HzFUN_INFO->Nzbin_TABLE, HzFUN_INFO->Nbin_MUINV,
+	   cacheFile );
+    fflush(stdout);
+  }
+  return true ;
+
+ INVALID:
+  if ( VBOSE ) {
+    printf("\t WARNING: ignore table cache file (%s):\n\t   %s\n",
+	   REASON, cacheFile);
+    fflush(stdout);
+  }
+  return false ;
+
+} // end read_HzFUN_TABLE_CACHE
+
+
+// ****************************************
+void write_HzFUN_TABLE_CACHE(int VBOSE, const HzFUN_INFO_DEF *HzFUN_INFO) {
+
+  // Created Oct 2026
+  // If table cache is enabled, write distance and inverse tables of
+  // HzFUN_INFO to cache file. The file is written under a unique
+  // temporary name and renamed, so that concurrent jobs never read
+  // a partial file; if two jobs write the same file, the last rename
+  // wins with identical content. Failure to write (e.g., read-only
+  // directory) is not fatal since the tables are already built;
+  // the warning is printed only if VBOSE.
+
+  HzFUN_TABLE_CACHE_HEADER_DEF HEAD ;
+  char   HEADER[NBYTE_HEADER_HzFUN_TABLE_CACHE] ;
+  char   cacheFile[MXPATHLEN+40], tmpFile[MXPATHLEN+60] ;
+  size_t Nt  = HzFUN_INFO->Nzbin_TABLE ;
+  size_t Nmu = HzFUN_INFO->Nbin_MUINV ;
+  size_t NWR ;
+  unsigned long long KEY, CHECKSUM ;
+  int    fd ;
+  FILE   *fp ;
+  bool   OK ;
+
+  // ----------- BEGIN ------------
+
+  if ( !HzFUN_INFO->USE_TABLE ) { return ; }
+  if ( !get_HzFUN_TABLE_CACHE_FILE(HzFUN_INFO, &KEY, cacheFile) )
+    { return ; }
+
+  memset(&HEAD, 0, sizeof(HzFUN_TABLE_CACHE_HEADER_DEF));
+  strncpy(HEAD.MAGIC, MAGIC_HzFUN_TABLE_CACHE, 8);
+  HEAD.VERSION     = VERSION_HzFUN_TABLE_CACHE ;
+  HEAD.IPREC       = HzFUN_INFO->IPREC ;
+  HEAD.Nzbin_TABLE = Nt ;
+  HEAD.Nbin_MUINV  = Nmu ;
+  HEAD.KEY         = KEY ;
+  get_HzFUN_TABLE_KEY(HzFUN_INFO, HEAD.COSPAR_KEY);
+  HEAD.H0REF_TABLE = HzFUN_INFO->H0REF_TABLE ;
+  HEAD.dz_TABLE    = HzFUN_INFO->dz_TABLE ;
+  HEAD.zmax_TABLE  = HzFUN_INFO->zmax_TABLE ;
+  if ( Nmu > 0 ) {
+    HEAD.mumin_MUINV = HzFUN_INFO->mumin_MUINV ;
+    HEAD.mumax_MUINV = HzFUN_INFO->mumax_MUINV ;
+    HEAD.dmu_MUINV   = HzFUN_INFO->dmu_MUINV ;
+  }
+
+  CHECKSUM = checksum_FNV1a(0,        HzFUN_INFO->DC_TABLE,   Nt*8);
+  CHECKSUM = checksum_FNV1a(CHECKSUM, HzFUN_INFO->EINV_TABLE, Nt*8);
+  if ( Nmu > 0 ) {
+    CHECKSUM = checksum_FNV1a(CHECKSUM, HzFUN_INFO->zCMB_MUINV,  Nmu*8);
+    CHECKSUM = checksum_FNV1a(CHECKSUM, HzFUN_INFO->dzdmu_MUINV, Nmu*8);
+  }
+  HEAD.CHECKSUM = CHECKSUM ;
+
+  memset(HEADER, 0, NBYTE_HEADER_HzFUN_TABLE_CACHE);
+  memcpy(HEADER, &HEAD, sizeof(HzFUN_TABLE_CACHE_HEADER_DEF));
+
+  snprintf(tmpFile, MXPATHLEN+60, "%s.tmpXXXXXX", cacheFile);
+  fd = mkstemp(tmpFile);
+  if ( fd < 0 || (fp = fdopen(fd,"wb")) == NULL ) {
+    if ( fd >= 0 ) { close(fd);  unlink(tmpFile); }
+    if ( VBOSE ) {
+      printf("\t WARNING: unable to write table cache file\n\t   %s\n",
+	     cacheFile);
+      fflush(stdout);
+    }
+    return ;
+  }
+
+  NWR  = fwrite(HEADER, 1, NBYTE_HEADER_HzFUN_TABLE_CACHE, fp);
+  NWR += fwrite(HzFUN_INFO->DC_TABLE,   sizeof(double), Nt, fp) * 8;
+  NWR += fwrite(HzFUN_INFO->EINV_TABLE, sizeof(double), Nt, fp) * 8;
+  if ( Nmu > 0 ) {
+    NWR += fwrite(HzFUN_INFO->zCMB_MUINV,  sizeof(double), Nmu, fp) * 8;
+    NWR += fwrite(HzFUN_INFO->dzdmu_MUINV, sizeof(double), Nmu, fp) * 8;
+  }
+  OK = ( NWR == NBYTE_HEADER_HzFUN_TABLE_CACHE + (2*Nt + 2*Nmu)*8 ) ;
+  OK = ( fclose(fp) == 0 ) && OK ;
+  OK = OK && ( chmod(tmpFile, 0644) == 0 ) ;  // mkstemp uses 0600
+  OK = OK && ( rename(tmpFile,cacheFile) == 0 ) ;
+
+  if ( !OK ) {
+    unlink(tmpFile);
+    if ( VBOSE ) {
+      printf("\t WARNING: unable to write table cache file\n\t   %s\n",
+	     cacheFile);
+      fflush(stdout);
+    }
+  }
+
+} // end write_HzFUN_TABLE_CACHE
+
+
+// ****************************************
+void init_HzFUN_TABLE(int VBOSE, HzFUN_INFO_DEF *HzFUN_INFO) {
+
+  // Created Oct 2026
+  // Tabulate dimensionless comoving distance
+  //    DC(z) = int_0^z H0/H(z') dz'
+  // on uniform z nodes from 0 to zmax_TABLE, along with the
+  // integrand H0/H(z) at each node. Each bin is integrated with
+  // 4-point Gauss-Legendre, which is exact to 1E-13 for smooth
+  // H(z); the DC(z) lookup is done in DC_TABLE_interp.
+  //
+  // For a map, zmax_TABLE is truncated at the last map redshift
+  // so that Hzfun_interp is never evaluated outside the map.
+  //
+  // Oct 2026: coarse bins for FAST tier; no table for REFERENCE tier.
+  // Oct 2026: store H0REF_TABLE = H0; see set_HzFUN_H0 to change H0.
+  // Oct 2026: read tables from on-disk cache if enabled and present;
+  //           otherwise build them and write cache file.
+
+  double H0    = HzFUN_INFO->COSPAR_LIST[ICOSPAR_HzFUN_H0];
+  double dz    = DZBIN_HzFUN_TABLE ;
+  double zmax  = ZMAX_HzFUN_TABLE ;
+  int    NGL   = NGL_HzFUN ;
+  const double *xGL = xGL_HzFUN, *wGL = wGL_HzFUN ;
+
+  int    NBIN_BLOCK = NBLOCK_HzFUN/5 ;
+  double zblock[NBLOCK_HzFUN], Hblock[NBLOCK_HzFUN];
+  int    Nzbin, iz, iz0, ib, nbin, igl, MEMD ;
+  double z0, zmid, sum ;
+
+  // ------------ BEGIN -------------
+
+  HzFUN_INFO->USE_TABLE = false ;
+  if ( HzFUN_INFO->IPREC == IPREC_HzFUN_REFERENCE ) { return ; }
+  if ( HzFUN_INFO->IPREC == IPREC_HzFUN_FAST ) { dz = DZBIN_HzFUN_TABLE_FAST; }
+
+  if ( HzFUN_INFO->USE_MAP ) {
+    int Nmap = HzFUN_INFO->Nzbin_MAP ;
+    double zmax_map = HzFUN_INFO->zCMB_MAP[Nmap-1] ;
+    if ( zmax_map < zmax ) { zmax = zmax_map ; }
+  }
+
+  Nzbin = (int)( zmax/dz + 1.0E-9 ) ;  // number of z bins
+  if ( Nzbin < 2 ) { return ; }
+
+  if ( read_HzFUN_TABLE_CACHE(VBOSE, HzFUN_INFO) ) { return ; }
+
+  MEMD = (Nzbin+1) * sizeof(double) ;
+  HzFUN_INFO->DC_TABLE   = (double*) malloc(MEMD);
+  HzFUN_INFO->EINV_TABLE = (double*) malloc(MEMD);
+
+  // evaluate H(z) in blocks of NBIN_BLOCK bins; each bin needs
+  // NGL Gauss-Legendre points plus the upper node.
+  sum = 0.0 ;
+  HzFUN_INFO->DC_TABLE[0]   = 0.0 ;
+  HzFUN_INFO->EINV_TABLE[0] = H0 / Hzfun(0.0, HzFUN_INFO);
+
+  for(iz0=1; iz0 <= Nzbin; iz0 += NBIN_BLOCK ) {
+    nbin = Nzbin - iz0 + 1 ;
+    if ( nbin > NBIN_BLOCK ) { nbin = NBIN_BLOCK; }
+
+    for(ib=0; ib < nbin; ib++ ) {
+      z0   = dz * (double)(iz0+ib-1) ;
+      zmid = z0 + 0.5*dz ;
+      for(igl=0; igl < NGL; igl++ ) 
+	{ zblock[ib*(NGL+1)+igl] = zmid + 0.5*dz*xGL[igl] ; }
+      zblock[ib*(NGL+1)+NGL] = z0 + dz ;
+    }
+    Hzfun_array(nbin*(NGL+1), zblock, HzFUN_INFO, Hblock);
+
+    for(ib=0; ib < nbin; ib++ ) {
+      for(igl=0; igl < NGL; igl++ ) 
+	{ sum += 0.5 * dz * wGL[igl] * H0 / Hblock[ib*(NGL+1)+igl] ; }
+      iz = iz0 + ib ;
+      HzFUN_INFO->DC_TABLE[iz]   = sum ;
+      HzFUN_INFO->EINV_TABLE[iz] = H0 / Hblock[ib*(NGL+1)+NGL] ;
+    }
+  }
+
+  HzFUN_INFO->Nzbin_TABLE = Nzbin + 1 ;
+  HzFUN_INFO->dz_TABLE    = dz ;
+  HzFUN_INFO->zmax_TABLE  = dz * (double)Nzbin ;
+  HzFUN_INFO->USE_TABLE   = true ;
+  HzFUN_INFO->H0REF_TABLE = H0 ;
+  set_HzFUN_TABLE_SCALE(HzFUN_INFO);
+
+  if ( VBOSE ) {
+    printf("\t Tabulate comoving distance: %d z-nodes, dz=%.4f, zmax=%.3f\n",
+	   HzFUN_INFO->Nzbin_TABLE, dz, HzFUN_INFO->zmax_TABLE );
+    fflush(stdout);
+  }
+
+  // tabulate inverse, zCMB(MU), for zcmb_dLmag_invert
+  init_MUINV_TABLE(VBOSE, HzFUN_INFO);
+
+  write_HzFUN_TABLE_CACHE(VBOSE, HzFUN_INFO);
+
+  return ;
+
+} // end init_HzFUN_TABLE
+
+
+// ****************************************
+void init_MUINV_TABLE(int VBOSE, HzFUN_INFO_DEF *HzFUN_INFO) {
+
+  // Created Oct 2026
+  // Tabulate isotropic inverse distance, zCMB(MU) with zHEL=zCMB,
+  // on a uniform MU grid from MU(ZMIN_MUINV_TABLE) to MU(zmax_TABLE).
+  // Each node is solved with Newton (see dLmag_dmudz) starting from
+  // the previous node; the slope dz/dMU is stored for cubic Hermite
+  // interpolation, and is limited (Fritsch-Carlson) so that the 
+  // interpolated zCMB(MU) is monotonic.
+  // Must be called after the distance table is built.
+  // Oct 2026: coarse MU bins for FAST tier.
+
+  double zmin = ZMIN_MUINV_TABLE ;
+  double zmax = HzFUN_INFO->zmax_TABLE ;
+  double DMUBIN = DMUBIN_MUINV_TABLE ;
+  double mumin, mumax, dmu, MU, z, mu, dmudz, delta, alpha, beta, tau ;
+  int    Nbin, imu, iter, MEMD ;
+  char fnam[] = "init_MUINV_TABLE" ;
+
+  // ----------- BEGIN ------------
+
+  HzFUN_INFO->Nbin_MUINV = 0 ;
+  if ( !HzFUN_INFO->USE_TABLE ) { return ; }
+  if ( HzFUN_INFO->IPREC == IPREC_HzFUN_FAST ) 
+    { DMUBIN = DMUBIN_MUINV_TABLE_FAST; }
+
+  mumin = dLmag_dmudz(zmin, HzFUN_INFO, &dmudz);
+  mumax = dLmag_dmudz(zmax, HzFUN_INFO, &dmudz);
+  Nbin  = (int)ceil( (mumax-mumin)/DMUBIN ) + 1 ;
+  dmu   = (mumax-mumin) / (double)(Nbin-1) ;
+
+  MEMD = Nbin * sizeof(double);
+  HzFUN_INFO->zCMB_MUINV  = (double*) malloc(MEMD);
+  HzFUN_INFO->dzdmu_MUINV = (double*) malloc(MEMD);
+
+  // z and dmudz stored for each node are evaluated together, after 
+  // the residual test, so that the slope belongs to the stored z.
+  z = zmin ;
+  for(imu=0; imu < Nbin; imu++ ) {
+    MU = mumin + dmu * (double)imu ;
+    for(iter=0; iter < MXITER_MUINV_TABLE; iter++ ) {
+      mu = dLmag_dmudz(z, HzFUN_INFO, &dmudz);
+      if ( fabs(mu-MU) < DMU_CONVERGE_MUINV ) { break; }
+      z *= exp( -(mu-MU) / (z*dmudz) ) ;   // Newton step in ln(z)
+    }
+    if ( fabs(mu-MU) >= DMU_CONVERGE_MUINV ) {
+      sprintf(c1err,"Newton did not converge for MU=%.6f (node %d)",
+	      MU, imu);
+      sprintf(c2err,"z=%le  |mu-MU|=%le after %d iterations", 
+	      z, fabs(mu-MU), MXITER_MUINV_TABLE );
+      errmsg(SEV_FATAL, 0, fnam, c1err, c2err); 
+    }
+    if ( z > zmax ) { z = zmax; mu = dLmag_dmudz(z, HzFUN_INFO, &dmudz); }
+    HzFUN_INFO->zCMB_MUINV[imu]  = z ;
+    HzFUN_INFO->dzdmu_MUINV[imu] = 1.0/dmudz ;
+  }
+
+  // limit slopes so that Hermite interpolation is monotonic
+  for(imu=0; imu < Nbin-1; imu++ ) {
+    delta = (HzFUN_INFO->zCMB_MUINV[imu+1]-HzFUN_INFO->zCMB_MUINV[imu])/dmu;
+    alpha = HzFUN_INFO->dzdmu_MUINV[imu]   / delta ;
+    beta  = HzFUN_INFO->dzdmu_MUINV[imu+1] / delta ;
+    if ( alpha*alpha + beta*beta > 9.0 ) {
+      tau = 3.0 / sqrt(alpha*alpha + beta*beta) ;
+      HzFUN_INFO->dzdmu_MUINV[imu]   = tau * alpha * delta ;
+      HzFUN_INFO->dzdmu_MUINV[imu+1] = tau * beta  * delta ;
+    }
+  }
+
+  HzFUN_INFO->Nbin_MUINV  = Nbin ;
+  HzFUN_INFO->mumin_MUINV = mumin ;
+  HzFUN_INFO->mumax_MUINV = mumin + dmu*(double)(Nbin-1) ;
+  HzFUN_INFO->dmu_MUINV   = dmu ;
+
+  if ( VBOSE ) {
+    printf("\t Tabulate zCMB(MU): %d MU-nodes from %.3f to %.3f \n",
+	   Nbin, mumin, HzFUN_INFO->mumax_MUINV );
+    fflush(stdout);
+  }
+
+  return ;
+
+} // end init_MUINV_TABLE
+
+
+// ****************************************
+double zcmb_MUINV_interp(double MU, const HzFUN_INFO_DEF *HzFUN_INFO) {
+
+  // Created Oct 2026
+  // Return isotropic zCMB for distance modulus MU using cubic 
+  // Hermite interpolation of MUINV table. Uniform MU nodes ->
+  // direct index. Caller must ensure mumin_MUINV <= MU <= mumax_MUINV.
+  // MU is for H0REF_TABLE; i.e., add DMU_MUINV to the MU for H0.
+
+  int    N    = HzFUN_INFO->Nbin_MUINV ;
+  double dmu  = HzFUN_INFO->dmu_MUINV ;
+  double *Z   = HzFUN_INFO->zCMB_MUINV ;
+  double *D   = HzFUN_INFO->dzdmu_MUINV ;
+  double x    = (MU - HzFUN_INFO->mumin_MUINV) / dmu ;
+  int    i    = (int)x ;
+  double t, t1 ;
+
+  if ( i > N-2 ) { i = N-2; }
+  t  = x - (double)i ;
+  t1 = 1.0 - t ;
+  return ( (1.0 + 2.0*t)*t1*t1 * Z[i] + t*t*(3.0 - 2.0*t) * Z[i+1] +
+	   dmu * ( t*t1*t1 * D[i] - t*t*t1 * D[i+1] ) ) ;
+
+} // end zcmb_MUINV_interp
+
+
+// ****************************************
+double DC_TABLE_interp(double z, const HzFUN_INFO_DEF *HzFUN_INFO) {
+
+  // Created Oct 2026
+  // Return dimensionless comoving distance DC(z) = int_0^z H0/H dz
+  // from cubic Hermite interpolation of DC_TABLE, using the exact
+  // slope EINV_TABLE at both ends of the bin. Uniform nodes ->
+  // bin index is computed directly without a search.
+  // Caller must ensure 0 <= z <= zmax_TABLE; out-of-range z is
+  // clamped to the first/last bin so that memory is never exceeded.
+  // Oct 2026: multiply by SCALE_TABLE (H0/H0REF_TABLE for map)
+
+  int    N    = HzFUN_INFO->Nzbin_TABLE ;
+  double dz   = HzFUN_INFO->dz_TABLE ;
+  double *DC  = HzFUN_INFO->DC_TABLE ;
+  double *E   = HzFUN_INFO->EINV_TABLE ;
+  double x    = z / dz ;
+  int    iz   = (int)x ;
+  double t, t1, h00, h10, h01, h11 ;
+
+  if ( iz > N-2 ) { iz = N-2; }
+  if ( iz < 0   ) { iz = 0;   }
+  t   = x - (double)iz ;
+  t1  = 1.0 - t ;
+  h00 = (1.0 + 2.0*t) * t1 * t1 ;
+  h10 = t * t1 * t1 ;
+  h01 = t * t * (3.0 - 2.0*t) ;
+  h11 = -t * t * t1 ;
+
+  return HzFUN_INFO->SCALE_TABLE * 
+    ( h00*DC[iz] + h01*DC[iz+1] + dz*(h10*E[iz] + h11*E[iz+1]) ) ;
+
+} // end DC_TABLE_interp
+
+
+// ****************************************
+void init_HzFUN_LCDM(HzFUN_INFO_DEF *HzFUN_INFO) {
+
+  // Created Oct 2026
+  // If cosmology is analytic LCDM (w0=-1, wa=0), prepare closed-form
+  // distance DC_LCDM_closed by factoring
+  //    E^2(x) = OM*x^3 + OK*x^2 + OL ,  x = 1+z
+  //           = (x - ROOT) * (OM*x^2 + G*x + F)
+  // where ROOT is the largest real root (trigonometric or Cardano
+  // solution, polished with Newton). Closed form is disabled for
+  // H(z) maps, OM < OMMIN_LCDM_CLOSED, or ROOT >= 1 (bounce).
+
+  double OM = HzFUN_INFO->COSPAR_LIST[ICOSPAR_HzFUN_OM] ;
+  double OL = HzFUN_INFO->COSPAR_LIST[ICOSPAR_HzFUN_OL] ;
+  double w0 = HzFUN_INFO->COSPAR_LIST[ICOSPAR_HzFUN_w0] ;
+  double wa = HzFUN_INFO->COSPAR_LIST[ICOSPAR_HzFUN_wa] ;
+  double OK = 1.0 - OM - OL ;
+  double a, c, p, q, D, t, sq, x, P, dP ;
+  int    iter ;
+
+  // ----------- BEGIN ------------
+
+  HzFUN_INFO->USE_LCDM_CLOSED = false ;
+  if ( HzFUN_INFO->USE_MAP )         { return ; }
+  if ( w0 != -1.0 || wa != 0.0 )     { return ; }
+  if ( OM < OMMIN_LCDM_CLOSED )      { return ; }
+
+  // x^3 + a*x^2 + c = 0 ; depressed with x = t - a/3 -> t^3 + p*t + q
+  a = OK / OM ;   c = OL / OM ;
+  p = -a*a/3.0 ;
+  q = 2.0*a*a*a/27.0 + c ;
+  D = 0.25*q*q + p*p*p/27.0 ;
+
+  if ( D >= 0.0 ) {
+    sq = sqrt(D) ;
+    t  = cbrt(-0.5*q + sq) + cbrt(-0.5*q - sq) ;
+  }
+  else {
+    sq = sqrt(-p/3.0) ;
+    t  = 2.0 * sq * cos( acos( -0.5*q / (sq*sq*sq) ) / 3.0 ) ;
+  }
+  x = t - a/3.0 ;
+
+  for(iter=0; iter < 3; iter++ ) {
+    P  = (x + a)*x*x + c ;
+    dP = (3.0*x + 2.0*a)*x ;
+    if ( dP == 0.0 ) { break; }
+    x -= P/dP ;
+  }
+
+  if ( x >= 1.0 ) { return ; }
+
+  HzFUN_INFO->ROOT_LCDM = x ;
+  HzFUN_INFO->G_LCDM    = OK + OM*x ;  // synthetic division by (x-ROOT)
+  HzFUN_INFO->F_LCDM    = x * HzFUN_INFO->G_LCDM ;
+  HzFUN_INFO->USE_LCDM_CLOSED = true ;
+
+} // end init_HzFUN_LCDM
+
+
+// ****************************************
+double DC_LCDM_closed(double zmin, double zmax, 
+		      const HzFUN_INFO_DEF *HzFUN_INFO) {
+
+  // Created Oct 2026
+  // Closed-form LCDM line-of-sight distance int_zmin^zmax H0/H dz
+  // (dimensionless, before curvature) for one linear and one
+  // quadratic factor (Carlson 1991, Math.Comp. 56, 267):
+  //    int_y^x dt / sqrt[(t-ROOT)*(h*t^2+g*t+f)] = 4*RF(M^2,L-^2,L+^2)
+  //    M^2  = [ (X1+Y1)*sqrt((xi+eta)^2 - h*(x-y)^2) / (x-y) ]^2
+  //    L+-^2 = M^2 - beta1 +- c11*sqrt(2h)
+  // with X1=sqrt(x-ROOT), Y1=sqrt(y-ROOT), xi,eta = sqrt(quadratic)
+  // at x,y, beta1 = g+2*h*ROOT, c11^2 = 2*(f + g*ROOT + h*ROOT^2).
+  // Requires init_HzFUN_LCDM -> USE_LCDM_CLOSED = true.
+
+  double h   = HzFUN_INFO->COSPAR_LIST[ICOSPAR_HzFUN_OM] ;
+  double g   = HzFUN_INFO->G_LCDM ;
+  double f   = HzFUN_INFO->F_LCDM ;
+  double r   = HzFUN_INFO->ROOT_LCDM ;
+  double x   = 1.0 + zmax,  y = 1.0 + zmin,  dx = zmax - zmin ;
+  double X1, Y1, xi, eta, M, M2, beta1, c11, L ;
+
+  if ( dx == 0.0 ) { return 0.0 ; }
+  if ( dx <  0.0 ) { return -DC_LCDM_closed(zmax, zmin, HzFUN_INFO); }
+
+  X1    = sqrt(x - r) ;
+  Y1    = sqrt(y - r) ;
+  xi    = sqrt( f + x*(g + h*x) ) ;
+  eta   = sqrt( f + y*(g + h*y) ) ;
+  M     = (X1 + Y1) * sqrt( (xi+eta)*(xi+eta) - h*dx*dx ) / dx ;
+  M2    = M * M ;
+  beta1 = g + 2.0*h*r ;
+  c11   = sqrt( fabs(2.0*(f + r*(g + h*r))) ) ;
+  L     = c11 * sqrt(2.0*h) ;
+
+  return 4.0 * RF_carlson(M2, M2 - beta1 - L, M2 - beta1 + L) ;
+
+} // end DC_LCDM_closed
+
+
+// ****************************************
+double RF_carlson(double x, double y, double z) {
+
+  // Created Oct 2026
+  // Carlson's symmetric elliptic integral of the first kind,
+  //    RF(x,y,z) = 1/2 int_0^inf dt / sqrt[(t+x)(t+y)(t+z)]
+  // by duplication (Carlson 1995, Numer.Algorithms 10, 13); 
+  // ERRTOL=0.0025 gives double precision. x,y,z >= 0, at most one 0.
+
+  double ERRTOL = 0.0025 ;
+  double C1 = 1.0/24.0, C2 = 0.1, C3 = 3.0/44.0, C4 = 1.0/14.0 ;
+  double sx, sy, sz, alamb, ave, delx, dely, delz, e2, e3 ;
+
+  do {
+    sx    = sqrt(x);  sy = sqrt(y);  sz = sqrt(z);
+    alamb = sx*(sy+sz) + sy*sz ;
+    x     = 0.25*(x+alamb) ;
+    y     = 0.25*(y+alamb) ;
+    z     = 0.25*(z+alamb) ;
+    ave   = (x+y+z) / 3.0 ;
+    delx  = (ave-x)/ave ;  dely = (ave-y)/ave ;  delz = (ave-z)/ave ;
+  } while ( fabs(delx) > ERRTOL || fabs(dely) > ERRTOL || 
+	    fabs(delz) > ERRTOL ) ;
+
+  e2 = delx*dely - delz*delz ;
+  e3 = delx*dely*delz ;
+  return ( 1.0 + (C1*e2 - C2 - C3*e3)*e2 + C4*e3 ) / sqrt(ave) ;
+
+} // end RF_carlson
+
+
+// ****************************************
+void write_HzFUN_FILE(const HzFUN_INFO_DEF *HzFUN_INFO ) {
+
+  // BEWARE: FOR DEBUG ONLY !
+  // write 2-column H(z) to text file, which is used
+  // to test reading H(z) file. Write in log(z) bins
+  // to make sure it can read non-uniform bins.
+  // Goal is to compare analytic Hzfun_wCDM with Hzfun_interp.
+  //
+  char *outFile = HzFUN_INFO->FILENAME;
+  double zCMB_min = 0.005;
+  double zCMB_max = ZMAX_SNANA ;
+  double logz_min = log10(zCMB_min);
+  double logz_max = log10(zCMB_max);
+  int    Nzbin    = 200 ;
+  double logz_bin = (logz_max - logz_min) / (double)Nzbin;
+
+  FILE *fp; 
+  double logz, z, Hz ;
+  int  iz;
+  char fnam[] = "write_HzFUN_FILE" ;
+  
+  // ---------- BEGIN ------------
+
+  printf("   Write H(z) to %s \n", outFile); 
+  printf("\t %d bins for zCMB = %.4f to %.4f \n", 
+	 Nzbin, zCMB_min, zCMB_max);
+  printf("\t logz(min,max,bin) = %f, %f, %f \n",
+	 logz_min, logz_max, logz_bin );
+  fflush(stdout);
+
+  fp = fopen(outFile,"wt");
+  if ( !fp ) {
+    sprintf(c1err,"Unable to open '%s' in write-text mode");
+    sprintf(c2err,"Check permisssions and if file already exists.") ;
+    errmsg(SEV_FATAL, 0, fnam, c1err, c2err);
+  }
+
+
+  // write documentation keys
+  fprintf(fp,"DOCUMENTATION: \n");
+  fprintf(fp,"  NOTES: \n");
+  fprintf(fp,"  - Auto generated by snlc_sim.exe  \n");
+  fprintf(fp,"  COSPAR: \n");
+  fprintf(fp,"    H0: %.2f \n" ,HzFUN_INFO->COSPAR_LIST[ICOSPAR_HzFUN_H0] );
+  fprintf(fp,"    OM: %.4f \n" ,HzFUN_INFO->COSPAR_LIST[ICOSPAR_HzFUN_OM] );
+  fprintf(fp,"    OL: %.4f \n" ,HzFUN_INFO->COSPAR_LIST[ICOSPAR_HzFUN_OL] );
+  fprintf(fp,"    w0: %.2f \n" ,HzFUN_INFO->COSPAR_LIST[ICOSPAR_HzFUN_w0] );
+  fprintf(fp,"    wa: %.2f \n" ,HzFUN_INFO->COSPAR_LIST[ICOSPAR_HzFUN_wa] );
+  fprintf(fp, "DOCUMENTATION_END: \n\n");
+
+  // Oct 2026: call Hzfun_wCDM directly so that COSPAR is used;
+  //   HzFUN_INFO is no longer modified (was USE_MAP=false,true)
+  for(iz=0; iz < Nzbin; iz++ ) {
+    if ( iz == 0 )
+      { z = 0.0 ; }
+    else {
+      logz = logz_min + logz_bin * (double)(iz-1) ;
+      z    = pow(TEN,logz);
+    }
+    Hz   = Hzfun_wCDM(z,HzFUN_INFO);
+    fprintf(fp," %7.5f  %9.4f\n", z, Hz);
+  }
+
+  fclose(fp);
+
+  return ;
+
+} // end write_HzFUN_FILE
+
+
+// ****************************
+double SFR_integral(double z, const HzFUN_INFO_DEF *HzFUN_INFO) {
+
+  /***
+   Integrate SFR(t) from 0 to current time.
+   For convenience, integrate  over 'a' instead of redshift
+   [since z goes to infinity]
+ 
+        /a
+       |   SFR(a') 
+     c |  ----------- da'
+       |  a' * H(a')
+       /0
+
+  ***/
+
+  int    NEVAL ;
+  double sum ;
+  COSMO_STATS_BEGIN ;
+  sum = SFR_integral_tol(z, get_TOLMAG_HzFUN(HzFUN_INFO), HzFUN_INFO, 
+			 &NEVAL);
+  COSMO_STATS_END(ISTAT_COSMO_SFR_integral);
+  return sum ;
+
+}  // end of function SFR_integral
+
+
+// ****************************
+double SFR_integral_tol(double z, double TOLMAG,
+			const HzFUN_INFO_DEF *HzFUN_INFO,
+			int *NEVAL) {
+
+  // Created Oct 2026
+  // Same as SFR_integral, but with user tolerance TOLMAG 
+  // (see integrate_GK15) and return number of SFR*H evaluations
+  // in NEVAL. Replaces 100-bin midpoint rule.
+
+  double AMIN, AMAX, tmp, sum ;
+  double SECONDS_PER_YEAR = 3600. * 24. * 365. ;
+  INTEG_PAR_COSMO_DEF PAR ;
+
+  // ---------- BEGIN ------------
+
+  AMIN = 0.0 ;
+  AMAX = 1. / (1. + z) ;
+
+  PAR.HzFUN_INFO = HzFUN_INFO ;
+  PAR.OPT        = 0 ;
+  PAR.SFRMODEL   = SFRMODEL_BG03 ;
+  PAR.SFRPAR     = NULL ;
+  sum = integrate_GK15(integrand_SFR, &PAR, AMIN, AMAX, TOLMAG, NEVAL);
+
+  // convert H (km/s/Mpc) to H(/year)
+  tmp = (1.0E6 * PC_km) / SECONDS_PER_YEAR ;
+  sum *= tmp ;
+  return sum ;
+
+}  // end of function SFR_integral_tol
+
+
+// ****************************
+double SFR_integral_MODEL(double z, int MODEL, double *params, 
+			  const HzFUN_INFO_DEF *HzFUN_INFO) {
+
+  // Created Oct 2026
+  // Same as SFR_integral, but for any SFR model (see SFRfun_MODEL);
+  // e.g., gives integral form of SFRfun_MD14.
+
+  double AMAX = 1. / (1. + z) ;
+  double SECONDS_PER_YEAR = 3600. * 24. * 365. ;
+  double sum ;
+  int    NEVAL ;
+  INTEG_PAR_COSMO_DEF PAR ;
+
+  PAR.HzFUN_INFO = HzFUN_INFO ;
+  PAR.OPT        = 0 ;
+  PAR.SFRMODEL   = MODEL ;
+  PAR.SFRPAR     = params ;
+  sum = integrate_GK15(integrand_SFR, &PAR, 0.0, AMAX, 
+		       get_TOLMAG_HzFUN(HzFUN_INFO), &NEVAL);
+
+  // convert H (km/s/Mpc) to H(/year)
+  sum *= (1.0E6 * PC_km) / SECONDS_PER_YEAR ;
+  return sum ;
+
+}  // end of function SFR_integral_MODEL
+
+
+// ****************************
+double SFRfun_BG03(double z, double H0) {
+
+  /***
+      Compute sfr(z) = (a+b*z)/(1+(z/c)^d)*h solar_mass/yr/Mpc^3
+      where H0 unit is km/s/Mpc and  h = H0/(100 km/s/Mpc)
+     
+      Oct 16 2020: rename SFRfun -> SFRfun_BG03
+  ***/
+
+  // -- Baldry and Glazebrook IMF --
+  // https://ui.adsabs.harvard.edu/abs/2003ApJ...593..258B
+
+  double a = 0.0118 ;
+  double b = 0.08 ;
+  double c = 3.3 ;
+  double d = 5.2 ;
+  double tmp1, tmp2, zc, h, SFRLOC;
+
+  // ------------ BEGIN --------------
+  zc   = z/c ;
+  tmp1 = a + b*z ;
+  tmp2 = 1.0 + pow(zc,d) ;
+  h    = H0 / 100. ; 
+  SFRLOC = h * tmp1 / tmp2 ;
+  return(SFRLOC) ;
+}  // end SFRfun_BG03
+
+
+// *******************************************
+double SFRfun_MD14(double z, double *params) {
+
+  // Created Dec 2016 by R.Kessler
+  // use function from  Madau & Dickoson 2014,
+  // that was also used in Strolger 2015 for CC rate.
+  // This function intended for CC rate, so beware
+  // using for other purposes (e.g., no H0 factor here).
+
+  double A      = params[0];
+  double B      = params[1];
+  double C      = params[2];
+  double D      = params[3];
+  double z1     = 1.0 + z;
+  double top    = A*pow(z1,C);
+  double bottom = 1.0 + pow( (z1/B), D );
+  double SFR    = top/bottom; // also see Eq 8+9 of Strolger 2015 
+  return(SFR);
+
+} // end SFRfun_MD14
+
+
+// *******************************************
+double SFRfun_MODEL(double z, int MODEL, double *params, double H0) {
+
+  // Created Oct 2026
+  // Dispatch to SFR model: 
+  //   MODEL = SFRMODEL_BG03 -> SFRfun_BG03(z,H0)   [params ignored]
+  //   MODEL = SFRMODEL_MD14 -> SFRfun_MD14(z,params)
+  //   MODEL = SFRMODEL_POWERLAW -> params[0]*(1+z)^params[1]  (Oct 2026)
+
+  char fnam[] = "SFRfun_MODEL" ;
+
+  char c1loc[200], c2loc[200] ; // local msg for thread safety
+
+  if ( MODEL == SFRMODEL_BG03 ) 
+    { return SFRfun_BG03(z,H0); }
+  else if ( MODEL == SFRMODEL_MD14 ) 
+    { return SFRfun_MD14(z,params); }
+  else if ( MODEL == SFRMODEL_POWERLAW ) 
+    { return params[0] * pow(1.0+z, params[1]); }
+  else {
+    sprintf(c1loc,"Invalid SFR MODEL = %d", MODEL);
+    sprintf(c2loc,"Valid MODELs are %d(BG03), %d(MD14), %d(POWERLAW)", 
+	    SFRMODEL_BG03, SFRMODEL_MD14, SFRMODEL_POWERLAW );
+    errmsg(SEV_FATAL, 0, fnam, c1loc, c2loc);
+  }
+  return 0.0 ;
+
+} // end SFRfun_MODEL
+
+
+// *******************************************
+int NPAR_SFRMODEL(int MODEL) {
+  // Created Oct 2026
+  // Return number of params read from params[] for SFR MODEL, so that
+  // callers copy only these (params[] may be shorter than 
+  // MXPAR_SFRMODEL). Invalid MODEL returns 0 (see SFRfun_MODEL).
+  if ( MODEL == SFRMODEL_MD14     ) { return 4 ; }
+  if ( MODEL == SFRMODEL_POWERLAW ) { return 2 ; }
+  return 0 ;
+} // end NPAR_SFRMODEL
+
+
+// *******************************************
+void init_SFR_TABLE(int VBOSE, int MODEL, double *params, double zmax,
+		    const HzFUN_INFO_DEF *HzFUN_INFO, SFR_TABLE_DEF *SFR_TABLE) {
+
+  // Created Oct 2026
+  // For input cosmology (HzFUN_INFO) and SFR model (MODEL, params),
+  // tabulate on uniform z nodes from 0 to zmax (binsize DZBIN_SFR_TABLE):
+  //   SFR          = SFR(z)
+  //   SFRINT       = SFR_integral(z) = cumulative stellar mass density
+  //                  formed before z  [int_z^inf SFR/((1+z)H) dz]
+  //   RATEdVdz     = SFR(z) * dV/dz
+  //   RATEdVdz_CUM = int_0^z RATEdVdz dz
+  // SFRINT is computed from zmax downward, starting from one
+  // adaptive integral above zmax; each bin (and each bin of 
+  // RATEdVdz_CUM) uses 4-point Gauss-Legendre. Lookups are done 
+  // with SFR_TABLE_interp. HzFUN_INFO is stored (not copied) and 
+  // must remain valid while table is used.
+
+  double H0   = HzFUN_INFO->COSPAR_LIST[ICOSPAR_HzFUN_H0];
+  double dz   = DZBIN_SFR_TABLE ;
+  double HUBTIME = (1.0E6 * PC_km) / (3600. * 24. * 365.) ;
+  const double *xGL = xGL_HzFUN, *wGL = wGL_HzFUN ;
+  double zGL[NGL_HzFUN], HGL[NGL_HzFUN], zmid, ztmp, sfr, sumInt, sumCum ;
+  int    Nzbin, iz, igl, ipar, NPAR, MEMD ;
+
+  // ------------ BEGIN -------------
+
+  Nzbin = (int)ceil( zmax/dz - 1.0E-9 ) ;
+  if ( Nzbin < 2 ) { Nzbin = 2; }
+  dz = zmax / (double)Nzbin ;
+
+  SFR_TABLE->MODEL      = MODEL ;
+  SFR_TABLE->HzFUN_INFO = HzFUN_INFO ;
+  SFR_TABLE->Nzbin      = Nzbin + 1 ;
+  SFR_TABLE->zmax       = zmax ;
+  SFR_TABLE->dz         = dz ;
+  // copy NPAR_SFRMODEL params (none for BG03; params may be NULL)
+  NPAR = NPAR_SFRMODEL(MODEL);
+  for(ipar=0; ipar < MXPAR_SFRMODEL; ipar++ ) 
+    { SFR_TABLE->PARAMS[ipar] = ( ipar < NPAR ) ? params[ipar] : 0.0 ; }
+
+  MEMD = (Nzbin+1) * sizeof(double);
+  SFR_TABLE->SFR          = (double*) malloc(MEMD);
+  SFR_TABLE->SFRINT       = (double*) malloc(MEMD);
+  SFR_TABLE->RATEdVdz     = (double*) malloc(MEMD);
+  SFR_TABLE->RATEdVdz_CUM = (double*) malloc(MEMD);
+
+  for(iz=0; iz <= Nzbin; iz++ ) {
+    ztmp = dz * (double)iz ;
+    SFR_TABLE->SFR[iz]      = 
+      SFRfun_MODEL(ztmp, MODEL, SFR_TABLE->PARAMS, H0);
+    SFR_TABLE->RATEdVdz[iz] = SFR_TABLE->SFR[iz] * dVdz(ztmp,HzFUN_INFO);
+  }
+
+  // stellar mass density: start above zmax, and integrate downward
+  sumInt = SFR_integral_MODEL(zmax, MODEL, SFR_TABLE->PARAMS, HzFUN_INFO);
+  SFR_TABLE->SFRINT[Nzbin] = sumInt ;
+  for(iz=Nzbin-1; iz >= 0; iz-- ) {
+    zmid = dz * ((double)iz + 0.5) ;
+    for(igl=0; igl < NGL_HzFUN; igl++ ) 
+      { zGL[igl] = zmid + 0.5*dz*xGL[igl]; }
+    Hzfun_array(NGL_HzFUN, zGL, HzFUN_INFO, HGL);
+    for(igl=0; igl < NGL_HzFUN; igl++ ) {
+      sfr = SFRfun_MODEL(zGL[igl], MODEL, SFR_TABLE->PARAMS, H0);
+      sumInt += 0.5*dz*wGL[igl] * HUBTIME * sfr / ((1.0+zGL[igl])*HGL[igl]);
+    }
+    SFR_TABLE->SFRINT[iz] = sumInt ;
+  }
+
+  // cumulative rate * dV/dz
+  sumCum = 0.0 ;
+  SFR_TABLE->RATEdVdz_CUM[0] = 0.0 ;
+  for(iz=1; iz <= Nzbin; iz++ ) {
+    zmid = dz * ((double)iz - 0.5) ;
+    for(igl=0; igl < NGL_HzFUN; igl++ ) {
+      ztmp = zmid + 0.5*dz*xGL[igl] ;
+      sfr  = SFRfun_MODEL(ztmp, MODEL, SFR_TABLE->PARAMS, H0);
+      sumCum += 0.5*dz*wGL[igl] * sfr * dVdz(ztmp,HzFUN_INFO) ;
+    }
+    SFR_TABLE->RATEdVdz_CUM[iz] = sumCum ;
+  }
+
+  if ( VBOSE ) {
+    printf("\t Tabulate SFR model %d: %d z-nodes up to z=%.3f \n",
+	   MODEL, Nzbin+1, zmax);
+    fflush(stdout);
+  }
+
+  return ;
+
+} // end init_SFR_TABLE
+
+
+// *******************************************
+double SFR_TABLE_interp(int IVAR, double z, SFR_TABLE_DEF *SFR_TABLE) {
+
+  // Created Oct 2026
+  // Return quantity IVAR (ISFRVAR_XXX) at redshift z.
+  // Cumulative quantities use cubic Hermite interpolation with exact
+  // slopes from the tabulated integrands. If z is outside the table, 
+  // SFRINT is computed directly.
+
+  const HzFUN_INFO_DEF *HzFUN_INFO = SFR_TABLE->HzFUN_INFO ;
+  double H0   = HzFUN_INFO->COSPAR_LIST[ICOSPAR_HzFUN_H0];
+  double HUBTIME = (1.0E6 * PC_km) / (3600. * 24. * 365. ) ;
+  int    MODEL = SFR_TABLE->MODEL ;
+  double *PARAMS = SFR_TABLE->PARAMS ;
+  int    N    = SFR_TABLE->Nzbin ;
+  double dz   = SFR_TABLE->dz ;
+  double x, t, t1, s0, s1, z0, z1, *Y ;
+  int    iz ;
+  char   fnam[] = "SFR_TABLE_interp" ;
+  char c1loc[200], c2loc[200] ; // local msg for thread safety
+
+  // ----------- BEGIN ------------
+
+  // SFR models are analytic with kinks (BG03), so pointwise 
+  // quantities are evaluated directly; dVdz uses the distance table.
+  if ( IVAR == ISFRVAR_SFR ) 
+    { return SFRfun_MODEL(z, MODEL, PARAMS, H0); }
+  if ( IVAR == ISFRVAR_RATEdVdz ) 
+    { return SFRfun_MODEL(z, MODEL, PARAMS, H0) * dVdz(z,HzFUN_INFO); }
+
+  if ( z < 0.0 || z > SFR_TABLE->zmax ) {
+    if ( IVAR == ISFRVAR_SFRINT ) 
+      { return SFR_integral_MODEL(z, MODEL, PARAMS, HzFUN_INFO); }
+    else {
+      sprintf(c1loc,"z=%f is outside SFR table (zmax=%f)", 
+	      z, SFR_TABLE->zmax);
+      sprintf(c2loc,"Increase zmax passed to init_SFR_TABLE.");
+      errmsg(SEV_FATAL, 0, fnam, c1loc, c2loc);
+    }
+  }
+
+  x  = z / dz ;
+  iz = (int)x ;
+  if ( iz > N-2 ) { iz = N-2; }
+  t  = x - (double)iz ;
+  t1 = 1.0 - t ;
+
+  if ( IVAR == ISFRVAR_SFRINT || IVAR == ISFRVAR_RATEdVdz_CUM ) {
+    z0 = dz*(double)iz ;  z1 = z0 + dz ;
+    if ( IVAR == ISFRVAR_SFRINT ) {
+      Y  = SFR_TABLE->SFRINT ;
+      s0 = -HUBTIME * SFR_TABLE->SFR[iz]   / ((1.0+z0)*Hzfun(z0,HzFUN_INFO));
+      s1 = -HUBTIME * SFR_TABLE->SFR[iz+1] / ((1.0+z1)*Hzfun(z1,HzFUN_INFO));
+    }
+    else {
+      Y  = SFR_TABLE->RATEdVdz_CUM ;
+      s0 = SFR_TABLE->RATEdVdz[iz] ;
+      s1 = SFR_TABLE->RATEdVdz[iz+1] ;
+    }
+    return ( (1.0 + 2.0*t)*t1*t1*Y[iz] + t*t*(3.0 - 2.0*t)*Y[iz+1] +
+	     dz * ( t*t1*t1*s0 - t*t*t1*s1 ) ) ;
+  }
+
+  sprintf(c1loc,"Invalid IVAR = %d", IVAR);
+  sprintf(c2loc,"See ISFRVAR_XXX in sntools_cosmology.h");
+  errmsg(SEV_FATAL, 0, fnam, c1loc, c2loc);
+  return 0.0 ;
+
+} // end SFR_TABLE_interp
+
+
+// *******************************************
+void free_SFR_TABLE(SFR_TABLE_DEF *SFR_TABLE) {
+  // Created Oct 2026: free memory allocated in init_SFR_TABLE
+  free(SFR_TABLE->SFR);
+  free(SFR_TABLE->SFRINT);
+  free(SFR_TABLE->RATEdVdz);
+  free(SFR_TABLE->RATEdVdz_CUM);
+  SFR_TABLE->Nzbin = 0 ;
+} // end free_SFR_TABLE
+
+
+// ==================================================
+//   redshift sampler (Oct 2026)
+// ==================================================
+
+// ******************************************
+void init_ZSAMPLER(int VBOSE, int MODEL, double *params, 
+		   double zmin, double zmax, 
+		   const HzFUN_INFO_DEF *HzFUN_INFO, ZSAMPLER_DEF *ZSAMPLER) {
+
+  // Created Oct 2026
+  // Prepare sampler for redshifts distributed as
+  //     dN/dz ~ RATE(z) * dV/dz / (1+z) ,  zmin < z < zmax
+  // with RATE = SFRfun_MODEL(z,MODEL,params,H0); e.g., SFRMODEL_MD14
+  // or SFRMODEL_POWERLAW. dN/dz is evaluated on uniform nodes 
+  // (binsize <= DZBIN_ZSAMPLER) and interpolated linearly, so that
+  // the CDF is piecewise quadratic and is inverted exactly in
+  // draw_ZSAMPLER. A guide table of Nzbin entries gives the bin
+  // in O(1) average time.
+  // dV/dz uses the distance table of HzFUN_INFO if it exists.
+
+  double H0 = HzFUN_INFO->COSPAR_LIST[ICOSPAR_HzFUN_H0];
+  int    Nzbin, iz, ig, ipar, NPAR, MEMD ;
+  double dz, z, sum ;
+  char fnam[] = "init_ZSAMPLER" ;
+
+  // ------------- BEGIN -------------
+
+  if ( zmin < 0.0 || zmax <= zmin ) {
+    sprintf(c1err,"Invalid z-range: zmin=%f zmax=%f", zmin, zmax);
+    sprintf(c2err,"Require 0 <= zmin < zmax");
+    errmsg(SEV_FATAL, 0, fnam, c1err, c2err);
+  }
+
+  Nzbin = (int)ceil( (zmax-zmin)/DZBIN_ZSAMPLER - 1.0E-9 ) ;
+  if ( Nzbin < 1 ) { Nzbin = 1; }
+  dz    = (zmax-zmin) / (double)Nzbin ;
+
+  ZSAMPLER->MODEL = MODEL ;
+  NPAR = NPAR_SFRMODEL(MODEL);
+  for(ipar=0; ipar < MXPAR_SFRMODEL; ipar++ ) 
+    { ZSAMPLER->PARAMS[ipar] = ( ipar < NPAR ) ? params[ipar] : 0.0 ; }
+  ZSAMPLER->zmin  = zmin ;
+  ZSAMPLER->zmax  = zmax ;
+  ZSAMPLER->dz    = dz ;
+  ZSAMPLER->Nzbin = Nzbin ;
+
+  MEMD = (Nzbin+1) * sizeof(double) ;
+  ZSAMPLER->PDF   = (double*) malloc(MEMD);
+  ZSAMPLER->CDF   = (double*) malloc(MEMD);
+  ZSAMPLER->GUIDE = (int*)    malloc( Nzbin * sizeof(int) );
+
+  for(iz=0; iz <= Nzbin; iz++ ) {
+    z = zmin + dz * (double)iz ;
+    ZSAMPLER->PDF[iz] = 
+      SFRfun_MODEL(z, MODEL, ZSAMPLER->PARAMS, H0) *
+      dVdz(z, HzFUN_INFO) / (1.0 + z) ;
+  }
+
+  // cumulative (trapezoid is exact for linear pdf), then normalize
+  sum = 0.0 ;  ZSAMPLER->CDF[0] = 0.0 ;
+  for(iz=0; iz < Nzbin; iz++ ) {
+    sum += 0.5 * dz * ( ZSAMPLER->PDF[iz] + ZSAMPLER->PDF[iz+1] ) ;
+    ZSAMPLER->CDF[iz+1] = sum ;
+  }
+
+  if ( !(sum > 0.0) ) {
+    sprintf(c1err,"Rate integral = %le for MODEL=%d", sum, MODEL);
+    sprintf(c2err,"zmin=%f zmax=%f", zmin, zmax);
+    errmsg(SEV_FATAL, 0, fnam, c1err, c2err);
+  }
+
+  ZSAMPLER->NORM = sum ;
+  for(iz=0; iz <= Nzbin; iz++ ) {
+    ZSAMPLER->PDF[iz] /= sum ;
+    ZSAMPLER->CDF[iz] /= sum ;
+  }
+  ZSAMPLER->CDF[Nzbin] = 1.0 ;
+
+  // GUIDE[ig] = first bin whose upper CDF exceeds ig/Nzbin
+  iz = 0 ;
+  for(ig=0; ig < Nzbin; ig++ ) {
+    while ( iz < Nzbin-1 && 
+	    ZSAMPLER->CDF[iz+1] <= (double)ig/(double)Nzbin ) { iz++ ; }
+    ZSAMPLER->GUIDE[ig] = iz ;
+  }
+
+  if ( VBOSE ) {
+    printf("\t %s: %d z-bins from %.4f to %.4f (MODEL=%d)\n",
+	   fnam, Nzbin, zmin, zmax, MODEL );
+    fflush(stdout);
+  }
+
+} // end init_ZSAMPLER
+
+
+// ******************************************
+double draw_ZSAMPLER(double U, const ZSAMPLER_DEF *ZSAMPLER) {
+
+  // Created Oct 2026
+  // Return redshift for uniform deviate 0 <= U < 1 (supplied by the
+  // calling function so that the simulation controls its random
+  // stream). The bin comes from the guide table plus a short forward
+  // search; within the bin, the linear pdf p(t) = p0 + s*t gives
+  //     U - CDF_i = p0*t + s*t^2/2
+  // which is solved with the cancellation-free root.
+  // Oct 2026: U outside [0,1) (or NaN) is clamped, so that the 
+  //   guide-table index is always valid.
+
+  int    Nzbin = ZSAMPLER->Nzbin ;
+  double dz    = ZSAMPLER->dz ;
+  const double *CDF = ZSAMPLER->CDF ;
+  const double *PDF = ZSAMPLER->PDF ;
+  int    iz, iguide ;
+  double R, p0, s, disc, t ;
+
+  if ( !(U >= 0.0) ) { U = 0.0 ; }
+  if (   U >= 1.0  ) { U = nextafter(1.0, 0.0) ; }
+
+  iguide = (int)(U * (double)Nzbin) ;
+  if ( iguide > Nzbin-1 ) { iguide = Nzbin-1 ; }
+  iz = ZSAMPLER->GUIDE[iguide] ;
+  while ( iz < Nzbin-1 && CDF[iz+1] <= U ) { iz++ ; }
+
+  R    = U - CDF[iz] ;
+  p0   = PDF[iz] ;
+  s    = ( PDF[iz+1] - p0 ) / dz ;
+  disc = p0*p0 + 2.0*s*R ;
+  if ( disc < 0.0 ) { disc = 0.0 ; }
+  t    = ( p0 + sqrt(disc) > 0.0 ) ? 2.0*R / ( p0 + sqrt(disc) ) : 0.0 ;
+  if ( t > dz ) { t = dz ; }
+
+  return ZSAMPLER->zmin + dz*(double)iz + t ;
+
+} // end draw_ZSAMPLER
+
+
+// ******************************************
+void draw_ZSAMPLER_array(int NDRAW, double *U, 
+			 const ZSAMPLER_DEF *ZSAMPLER, double *z) {
+  // Created Oct 2026
+  // Batch version of draw_ZSAMPLER: z[i] for uniform deviates U[i]
+  int i ;
+  for(i=0; i < NDRAW; i++ ) { z[i] = draw_ZSAMPLER(U[i], ZSAMPLER); }
+} // end draw_ZSAMPLER_array
+
+
+// ******************************************
+void free_ZSAMPLER(ZSAMPLER_DEF *ZSAMPLER) {
+  // Created Oct 2026: free memory allocated in init_ZSAMPLER
+  free(ZSAMPLER->PDF);
+  free(ZSAMPLER->CDF);
+  free(ZSAMPLER->GUIDE);
+  ZSAMPLER->Nzbin = 0 ;
+} // end free_ZSAMPLER
+
+
+
+// *******************************************
+double dVdz_integral(int OPT, double zmax, const HzFUN_INFO_DEF *HzFUN_INFO) {
+
+  //
+  // return integral of dV/dz = r(z)^2/H(z) dz
+  // OPT = 0:  returns standard volume integral
+  // OPT = 1:  returns  z-wgted integral
+
+  // Oct 2026: 
+  //  + with distance table, dVdz is O(1) -> adaptive quadrature
+  //    in dVdz_integral_tol.
+  //  + without table, use single-pass dVdz_integral_curve so that
+  //    the comoving distance is carried forward instead of being
+  //    re-integrated from zero for every z.
+  //  + REFERENCE tier: nested adaptive quadrature (no table).
+
+  int    NEVAL ;
+  double zarr[2], V0[2], V1[2], VOL ;
+  COSMO_STATS_BEGIN ;
+
+  if ( HzFUN_INFO->USE_TABLE || 
+       HzFUN_INFO->IPREC == IPREC_HzFUN_REFERENCE ) {
+    VOL = dVdz_integral_tol(OPT, zmax, get_TOLMAG_HzFUN(HzFUN_INFO),
+			    HzFUN_INFO, &NEVAL);
+  }
+  else {
+    dVdz_integral_curve(zmax, 1, HzFUN_INFO, zarr, V0, V1);
+    VOL = ( OPT == 1 ) ? V1[1] : V0[1] ;
+  }
+
+  COSMO_STATS_END(ISTAT_COSMO_dVdz_integral);
+  return VOL ;
+
+}  // end of dVdz_integral
+
+
+// *******************************************
+void dVdz_integral_curve(double zmax, int NZBIN,
+			 const HzFUN_INFO_DEF *HzFUN_INFO,
+			 double *zarr, double *V0, double *V1) {
+
+  // Created Oct 2026
+  // Single pass (O(N)) computation of cumulative volume curves
+  //    V0[i] = int_0^z[i]   dV/dz dz     (OPT=0 in dVdz_integral)
+  //    V1[i] = int_0^z[i] z*dV/dz dz     (OPT=1 in dVdz_integral)
+  // at NZBIN+1 uniform nodes zarr[i] = i*zmax/NZBIN, i=0..NZBIN.
+  // Output arrays must be allocated by calling function.
+  //
+  // Each output bin is split into sub-bins of at most DZBIN_dVdz_CURVE,
+  // with at least NSUBMIN_dVdz_CURVE sub-bins over the full curve so
+  // that Simpson error stays small relative to V(<z) at low zmax.
+  // The dimensionless comoving distance is carried forward from the
+  // previous sub-bin using 2-point Gauss-Legendre on each half of the
+  // sub-bin, and the volume integrand uses Simpson's rule on the
+  // sub-bin edges and midpoint. 6 H(z) evaluations per sub-bin.
+
+  double H0  = HzFUN_INFO->COSPAR_LIST[ICOSPAR_HzFUN_H0];
+  double GL2 = 0.5/sqrt(3.0) ;
+  double dz, h, z, zm, zb, DC, DCm, DCb, rm, rb, fa, fm, fb ;
+  double sum0, sum1, zblock[6], Hblock[6] ;
+  int    ibin, isub, nsub ;
+
+  // ------------ BEGIN ------------
+
+  zarr[0] = V0[0] = V1[0] = 0.0 ;
+  if ( NZBIN < 1 || zmax <= 0.0 ) { return ; }
+
+  dz   = zmax / (double)NZBIN ;
+  nsub = (int)ceil( dz / DZBIN_dVdz_CURVE );
+  if ( nsub*NZBIN < NSUBMIN_dVdz_CURVE ) 
+    { nsub = (NSUBMIN_dVdz_CURVE + NZBIN - 1) / NZBIN ; }
+  h    = dz / (double)nsub ;
+
+  z = DC = fa = sum0 = sum1 = 0.0 ;  // dV/dz = 0 at z=0
+
+  for(ibin=1; ibin <= NZBIN; ibin++ ) {
+    for(isub=0; isub < nsub; isub++ ) {
+      zm = z + 0.5*h ;
+      zb = z + h ;
+      zblock[0] = z  + 0.25*h - GL2*0.5*h ;
+      zblock[1] = z  + 0.25*h + GL2*0.5*h ;
+      zblock[2] = zm + 0.25*h - GL2*0.5*h ;
+      zblock[3] = zm + 0.25*h + GL2*0.5*h ;
+      zblock[4] = zm ;
+      zblock[5] = zb ;
+      Hzfun_array(6, zblock, HzFUN_INFO, Hblock);
+
+      DCm = DC  + 0.25*h*H0*( 1.0/Hblock[0] + 1.0/Hblock[1] ) ;
+      DCb = DCm + 0.25*h*H0*( 1.0/Hblock[2] + 1.0/Hblock[3] ) ;
+      rm  = Hzinv_curvature(DCm, HzFUN_INFO);
+      rb  = Hzinv_curvature(DCb, HzFUN_INFO);
+      fm  = LIGHT_km * rm * rm / Hblock[4] ;
+      fb  = LIGHT_km * rb * rb / Hblock[5] ;
+
+      sum0 += h/6.0 * ( fa   + 4.0*fm    + fb ) ;
+      sum1 += h/6.0 * ( z*fa + 4.0*zm*fm + zb*fb ) ;
+
+      z = zb;  DC = DCb;  fa = fb ;
+    }
+    zarr[ibin] = dz * (double)ibin ;
+    V0[ibin]   = sum0 ;
+    V1[ibin]   = sum1 ;
+  }
+
+  return ;
+
+}  // end of dVdz_integral_curve
+
+
+// *******************************************
+double dVdz_integral_tol(int OPT, double zmax, double TOLMAG, 
+			 const HzFUN_INFO_DEF *HzFUN_INFO, int *NEVAL) {
+
+  // Created Oct 2026
+  // Same as dVdz_integral, but with user tolerance TOLMAG 
+  // (see integrate_GK15) and return number of dVdz evaluations.
+
+  INTEG_PAR_COSMO_DEF PAR ;
+  PAR.HzFUN_INFO = HzFUN_INFO ;
+  PAR.OPT        = OPT ;
+  return integrate_GK15(integrand_dVdz, &PAR, 0.0, zmax, TOLMAG, NEVAL);
+
+}  // end of dVdz_integral_tol
+
+
+// ==================================================
+//   LRU cache of tabulated cosmologies (Oct 2026)
+// ==================================================
+
+static COSMO_CACHE_DEF COSMO_CACHE ;  // zero-initialized
+
+static COSMO_CACHE_ENTRY_DEF *find_COSMO_CACHE(double *KEY, bool ADD) {
+  // Created Oct 2026
+  // Return cache entry for KEY. If ADD=true, count this request and 
+  // replace the least-recently-used entry by a new key; if ADD=false,
+  // return NULL for a key that is not in the cache.
+  // Calling function must hold the COSMO_CACHE omp critical lock.
+  int    NBYTE_KEY = NCOSPAR_HzFUN * sizeof(double) ;
+  int    ientry, iLRU = 0 ;
+  COSMO_CACHE_ENTRY_DEF *ENTRY ;
+
+  if ( ADD ) { COSMO_CACHE.CLOCK++ ; }
+  for(ientry=0; ientry < MXENTRY_COSMO_CACHE; ientry++ ) {
+    ENTRY = &COSMO_CACHE.ENTRY[ientry] ;
+    if ( ENTRY->NSEEN > 0 && 
+	 memcmp(ENTRY->COSPAR_LIST, KEY, NBYTE_KEY) == 0 ) {
+      if ( ADD ) { ENTRY->NSEEN++ ;  ENTRY->LAST_USE = COSMO_CACHE.CLOCK; }
+      return ENTRY ;
+    }
+    if ( ENTRY->LAST_USE < COSMO_CACHE.ENTRY[iLRU].LAST_USE ) 
+      { iLRU = ientry; }
+  }
+  if ( !ADD ) { return NULL ; }
+
+  // new key: replace least-recently-used entry (empty entries have
+  // LAST_USE=0, so they are used first). An item still used by
+  // another thread is freed by its last release_COSMO_CACHE.
+  ENTRY = &COSMO_CACHE.ENTRY[iLRU] ;
+  if ( ENTRY->NSEEN > 0 ) { COSMO_CACHE.NEVICT++ ; }
+  if ( ENTRY->ITEM != NULL ) { release_COSMO_CACHE(ENTRY->ITEM); }
+  memcpy(ENTRY->COSPAR_LIST, KEY, NBYTE_KEY);
+  ENTRY->NSEEN    = 1 ;
+  ENTRY->ITEM     = NULL ;
+  ENTRY->LAST_USE = COSMO_CACHE.CLOCK ;
+  return ENTRY ;
+} // end find_COSMO_CACHE
+
+
+// ******************************************
+COSMO_CACHE_ITEM_DEF *get_COSMO_CACHE(double *COSPAR) {
+
+  // Created Oct 2026
+  // Return cache item with tables for cosmology COSPAR, or NULL if 
+  // COSPAR has been requested fewer than NSEEN_BUILD_COSMO_CACHE 
+  // times (calling function then computes without tables).
+  // Key match is on the exact bits of COSPAR (memcmp).
+  // New keys replace the least-recently-used entry.
+  // Oct 2026: key ignores H0; the calling function copies the item's
+  //   HzFUN_INFO and applies its own H0 with set_HzFUN_H0, so that
+  //   H0 scans reuse the same tables.
+  // Oct 2026: the COSMO_CACHE lock is held only for lookup; tables
+  //   are built outside the lock (create_HzFUN_INFO, which may read
+  //   the on-disk table cache). The returned item is retained, and
+  //   the calling function must call release_COSMO_CACHE when done.
+
+  int    NBYTE_KEY = NCOSPAR_HzFUN * sizeof(double) ;
+  double KEY[NCOSPAR_HzFUN] ;
+  bool   BUILD = false ;
+  COSMO_CACHE_ITEM_DEF  *ITEM = NULL, *ITEM_NEW ;
+  COSMO_CACHE_ENTRY_DEF *ENTRY ;
+
+  // ------------- BEGIN -------------
+
+  memcpy(KEY, COSPAR, NBYTE_KEY);
+  KEY[ICOSPAR_HzFUN_H0] = 0.0 ;
+
+#ifdef _OPENMP
+#pragma omp critical(COSMO_CACHE)
+#endif
+  {
+    ENTRY = find_COSMO_CACHE(KEY, true);
+    if ( ENTRY->ITEM != NULL ) {
+      ITEM = ENTRY->ITEM ;
+      __atomic_add_fetch(&ITEM->NREF, 1, __ATOMIC_RELAXED);
+      COSMO_CACHE.NHIT++ ;
+    }
+    else {
+      COSMO_CACHE.NMISS++ ;
+      BUILD = ( ENTRY->NSEEN >= NSEEN_BUILD_COSMO_CACHE ) ;
+    }
+  }
+  if ( !BUILD ) { return ITEM ; }
+
+  // build tables without holding the lock
+  ITEM_NEW = (COSMO_CACHE_ITEM_DEF*) calloc(1, sizeof(COSMO_CACHE_ITEM_DEF));
+  ITEM_NEW->NREF       = 1 ;   // calling function
+  ITEM_NEW->HzFUN_INFO = create_HzFUN_INFO(0, COSPAR, "NONE");
+
+  // store in cache unless another thread was faster, or the key 
+  // was evicted in the meantime (then item is used only once).
+#ifdef _OPENMP
+#pragma omp critical(COSMO_CACHE)
+#endif
+  {
+    ENTRY = find_COSMO_CACHE(KEY, false);
+    if ( ENTRY != NULL && ENTRY->ITEM != NULL ) {
+      ITEM = ENTRY->ITEM ;
+      __atomic_add_fetch(&ITEM->NREF, 1, __ATOMIC_RELAXED);
+    }
+    else {
+      ITEM = ITEM_NEW ;  ITEM_NEW = NULL ;
+      if ( ENTRY != NULL ) { 
+	ENTRY->ITEM = ITEM ;
+	__atomic_add_fetch(&ITEM->NREF, 1, __ATOMIC_RELAXED);
+      }
+    }
+  }
+  if ( ITEM_NEW != NULL ) { release_COSMO_CACHE(ITEM_NEW); }
+
+  return ITEM ;
+
+} // end get_COSMO_CACHE
+
+
+// ******************************************
+void release_COSMO_CACHE(COSMO_CACHE_ITEM_DEF *ITEM) {
+
+  // Created Oct 2026
+  // Drop one reference to cache item (from get_COSMO_CACHE); the last
+  // reference frees the tables and volume curves. Thread safe.
+
+  if ( __atomic_sub_fetch(&ITEM->NREF, 1, __ATOMIC_ACQ_REL) > 0 ) 
+    { return ; }
+
+  release_HzFUN_INFO(ITEM->HzFUN_INFO);
+  if ( ITEM->Nzbin_VOL > 0 ) 
+    { free(ITEM->V0_VOL);  free(ITEM->V1_VOL);  free(ITEM->DVDZ_VOL); }
+  free(ITEM);
+
+} // end release_COSMO_CACHE
+
+
+// ******************************************
+double dVdz_integral_COSMO_CACHE(int OPT, double zmax, double H0,
+				 COSMO_CACHE_ITEM_DEF *ITEM) {
+
+  // Created Oct 2026
+  // dVdz_integral for cached cosmology: on first use, build cumulative
+  // volume curves (dVdz_integral_curve) on the distance-table z range,
+  // then return cubic Hermite interpolation using exact slopes
+  // dV/dz and z*dV/dz. Outside the curve, call dVdz_integral.
+  // Oct 2026: curves are for H0 of the item; volume scales as H0^-3.
+  // Oct 2026: curves are built once under lock COSMO_CACHE_VOL, and
+  //   are read-only afterwards (Nzbin_VOL is published last).
+
+  const HzFUN_INFO_DEF *HzFUN_INFO = ITEM->HzFUN_INFO ;
+  double H0REF = HzFUN_INFO->COSPAR_LIST[ICOSPAR_HzFUN_H0] ;
+  double FAC   = pow(H0REF/H0, 3.0) ;
+  double *zarr, *V, dz, x, t, t1, z0, z1, s0, s1 ;
+  int    N, iz, MEMD ;
+
+  // ------------- BEGIN -------------
+
+  if ( __atomic_load_n(&ITEM->Nzbin_VOL, __ATOMIC_ACQUIRE) == 0 ) {
+#ifdef _OPENMP
+#pragma omp critical(COSMO_CACHE_VOL)
+#endif
+    {
+      if ( ITEM->Nzbin_VOL == 0 ) {
+	N    = (int)( HzFUN_INFO->zmax_TABLE/DZBIN_VOL_COSMO_CACHE + 1.0E-9 );
+	MEMD = (N+1) * sizeof(double) ;
+	zarr = (double*) malloc(MEMD);
+	ITEM->V0_VOL   = (double*) malloc(MEMD);
+	ITEM->V1_VOL   = (double*) malloc(MEMD);
+	ITEM->DVDZ_VOL = (double*) malloc(MEMD);
+	dVdz_integral_curve(N*DZBIN_VOL_COSMO_CACHE, N, HzFUN_INFO, 
+			    zarr, ITEM->V0_VOL, ITEM->V1_VOL);
+	for(iz=0; iz <= N; iz++ ) 
+	  { ITEM->DVDZ_VOL[iz] = dVdz(zarr[iz], HzFUN_INFO); }
+	ITEM->dz_VOL    = zarr[1] - zarr[0] ;
+	ITEM->zmax_VOL  = zarr[N] ;
+	free(zarr);
+	__atomic_store_n(&ITEM->Nzbin_VOL, N+1, __ATOMIC_RELEASE);
+      }
+    }
+  }
+
+  // V ~ z^3 (z^4 for OPT=1) is not cubic-like at small z, so
+  // fall back to table-based integral below ZMIN_VOL_COSMO_CACHE.
+  if ( zmax < ZMIN_VOL_COSMO_CACHE || zmax > ITEM->zmax_VOL ) 
+    { return FAC * dVdz_integral(OPT, zmax, HzFUN_INFO); }
+
+  N  = ITEM->Nzbin_VOL ;
+  dz = ITEM->dz_VOL ;
+  x  = zmax / dz ;
+  iz = (int)x ;
+  if ( iz > N-2 ) { iz = N-2; }
+  t  = x - (double)iz ;   t1 = 1.0 - t ;
+  z0 = dz*(double)iz ;    z1 = z0 + dz ;
+  s0 = ITEM->DVDZ_VOL[iz] ;  s1 = ITEM->DVDZ_VOL[iz+1] ;
+  if ( OPT == 1 ) 
+    { V = ITEM->V1_VOL ;  s0 *= z0 ;  s1 *= z1 ; }
+  else
+    { V = ITEM->V0_VOL ; }
+
+  return FAC * ( (1.0 + 2.0*t)*t1*t1*V[iz] + t*t*(3.0 - 2.0*t)*V[iz+1] +
+		 dz * ( t*t1*t1*s0 - t*t*t1*s1 ) ) ;
+
+} // end dVdz_integral_COSMO_CACHE
+
+
+// ******************************************
+void reset_COSMO_CACHE(void) {
+  // Created Oct 2026: release all cached items and reset counters;
+  // items still in use are freed by their last release_COSMO_CACHE.
+  int ientry ;
+  COSMO_CACHE_ENTRY_DEF *ENTRY ;
+#ifdef _OPENMP
+#pragma omp critical(COSMO_CACHE)
+#endif
+  {
+    for(ientry=0; ientry < MXENTRY_COSMO_CACHE; ientry++ ) {
+      ENTRY = &COSMO_CACHE.ENTRY[ientry] ;
+      if ( ENTRY->ITEM != NULL ) { release_COSMO_CACHE(ENTRY->ITEM); }
+    }
+    memset(&COSMO_CACHE, 0, sizeof(COSMO_CACHE_DEF));
+  }
+} // end reset_COSMO_CACHE
+
+
+// ******************************************
+void get_COSMO_CACHE_STATS(long *NHIT, long *NMISS, long *NEVICT) {
+  // Created Oct 2026: return cache counters, read under the same
+  // lock as get_COSMO_CACHE updates them.
+#ifdef _OPENMP
+#pragma omp critical(COSMO_CACHE)
+#endif
+  {
+    *NHIT   = COSMO_CACHE.NHIT ;
+    *NMISS  = COSMO_CACHE.NMISS ;
+    *NEVICT = COSMO_CACHE.NEVICT ;
+  }
+} // end get_COSMO_CACHE_STATS
+
+void cosmo_cache_stats__(long *NHIT, long *NMISS, long *NEVICT) {
+  get_COSMO_CACHE_STATS(NHIT, NMISS, NEVICT);
+}
+
+
+double dvdz_integral__(int *OPT, double *zmax, double *COSPAR) {
+
+  // Oct 2026: use LRU cache of tabulated cosmologies (get_COSMO_CACHE)
+  HzFUN_INFO_DEF HzFUN_INFO;
+  COSMO_CACHE_ITEM_DEF *ITEM ;
+  double VOL ;
+  int ipar;
+
+  ITEM = get_COSMO_CACHE(COSPAR);
+  if ( ITEM != NULL ) {
+    VOL = dVdz_integral_COSMO_CACHE(*OPT, *zmax, 
+				    COSPAR[ICOSPAR_HzFUN_H0], ITEM);
+    release_COSMO_CACHE(ITEM);
+    return VOL ;
+  }
+
+  HzFUN_INFO.USE_MAP   = false ;
+  HzFUN_INFO.USE_TABLE = false ;
+  HzFUN_INFO.IPREC     = IPREC_HzFUN_STANDARD ;
+  for (ipar=0; ipar < NCOSPAR_HzFUN; ipar++ ) 
+    { HzFUN_INFO.COSPAR_LIST[ipar] = COSPAR[ipar]; }
+  init_HzFUN_LCDM(&HzFUN_INFO);
+
+  return dVdz_integral(*OPT, *zmax, &HzFUN_INFO);
+}
+
+
+void dvdz_integral_curve__(int *NZBIN, double *zmax, double *COSPAR,
+			   double *zarr, double *V0, double *V1) {
+
+  // Created Oct 2026
+  // Fortran interface to dVdz_integral_curve: return full cumulative
+  // V(<z) curves (standard and z-weighted) in one call.
+  HzFUN_INFO_DEF HzFUN_INFO;
+  int ipar;
+
+  HzFUN_INFO.USE_MAP   = false ;
+  HzFUN_INFO.USE_TABLE = false ;
+  HzFUN_INFO.IPREC     = IPREC_HzFUN_STANDARD ;
+  for (ipar=0; ipar < NCOSPAR_HzFUN; ipar++ ) 
+    { HzFUN_INFO.COSPAR_LIST[ipar] = COSPAR[ipar]; }
+  init_HzFUN_LCDM(&HzFUN_INFO);
+
+  dVdz_integral_curve(*zmax, *NZBIN, &HzFUN_INFO, zarr, V0, V1);
+}
+
+
+// **********************************
+double dVdz(double z, const HzFUN_INFO_DEF *HzFUN_INFO) {
+  // returns dV/dz = r(z)^2 / H(z)
+  double r, H, tmp ;
+  double zmin = 0.0;
+  r = Hzinv_integral (zmin, z, HzFUN_INFO);
+  H = Hzfun ( z, HzFUN_INFO);
+  tmp = LIGHT_km * r * r / H ;
+  return tmp;
+}  // end of dVdz
+
+
+// ******************************************
+double Hzinv_integral(double zmin, double zmax,
+		      const HzFUN_INFO_DEF *HzFUN_INFO) {
+
+  // ------ return integral c*r(z) = int c*dz/H(z) -------------
+  // Note that D_L = (1+z)*Hzinv_integral
+  //
+  // Oct 2026: use cumulative table if zmin,zmax are covered;
+  //           else adaptive quadrature (see Hzinv_integral_tol)
+
+  int    NEVAL ;
+  double rz ;
+  COSMO_STATS_BEGIN ;
+  rz = Hzinv_integral_tol(zmin, zmax, get_TOLMAG_HzFUN(HzFUN_INFO), 
+			  HzFUN_INFO, &NEVAL);
+  COSMO_STATS_END(ISTAT_COSMO_Hzinv_integral);
+  return rz ;
+
+} // end of Hzinv_integral
+
+
+// ******************************************
+double Hzinv_integral_tol(double zmin, double zmax, double TOLMAG,
+			  const HzFUN_INFO_DEF *HzFUN_INFO, int *NEVAL) {
+
+  // Created Oct 2026
+  // Same as Hzinv_integral, but with user tolerance TOLMAG 
+  // (see integrate_GK15), and return number of H(z) evaluations
+  // in NEVAL (0 for table lookup).
+
+  double sum = Hzinv_sum(zmin, zmax, TOLMAG, HzFUN_INFO, NEVAL);
+
+  // apply curvature and c/H0 factor
+  return Hzinv_curvature(sum, HzFUN_INFO) ;
+
+} // end of Hzinv_integral_tol
+
+
+// ******************************************
+double Hzinv_sum(double zmin, double zmax, double TOLMAG,
+		 const HzFUN_INFO_DEF *HzFUN_INFO, int *NEVAL) {
+
+  // Created Oct 2026
+  // Return dimensionless line-of-sight distance int H0/H(z) dz
+  // from zmin to zmax (before curvature): use table if zmin,zmax
+  // are covered, else closed form for LCDM, else adaptive quadrature.
+  // Negative redshifts (e.g., -9 flags) always use quadrature,
+  // which returns NaN as before the tables.
+
+  double sum ;
+  bool   ZPOS = ( zmin >= 0.0 && zmax >= 0.0 ) ;
+  INTEG_PAR_COSMO_DEF PAR ;
+
+  *NEVAL = 0 ;
+
+  if ( HzFUN_INFO->USE_TABLE && ZPOS && 
+       zmin <= HzFUN_INFO->zmax_TABLE && 
+       zmax <= HzFUN_INFO->zmax_TABLE ) {
+    sum = DC_TABLE_interp(zmax,HzFUN_INFO) - 
+      DC_TABLE_interp(zmin,HzFUN_INFO) ;
+  }
+  else if ( HzFUN_INFO->USE_LCDM_CLOSED && ZPOS ) {
+    sum = DC_LCDM_closed(zmin, zmax, HzFUN_INFO);
+  }
+  else {
+    PAR.HzFUN_INFO = HzFUN_INFO ;
+    PAR.OPT        = 0 ;
+    sum = integrate_GK15(integrand_Hzinv, &PAR, zmin, zmax, TOLMAG, NEVAL);
+  }
+
+  return sum ;
+
+} // end of Hzinv_sum
+
+
+// ******************************************
+double Hainv_integral(double amin, double amax,
+		      const HzFUN_INFO_DEF *HzFUN_INFO) {
+
+  // Same as Hzinv_integral, but integrate over a instead of over z.
+  // dz/E(z) :  z=1/a-1   dz = -da/a^2
+
+  int NEVAL ;
+  return Hainv_integral_tol(amin, amax, get_TOLMAG_HzFUN(HzFUN_INFO), 
+			    HzFUN_INFO, &NEVAL);
+
+} // end of Hainv_integral
+
+
+// ******************************************
+double Hainv_integral_tol(double amin, double amax, double TOLMAG,
+			  const HzFUN_INFO_DEF *HzFUN_INFO, int *NEVAL) {
+
+  // Created Oct 2026
+  // Same as Hainv_integral, but with user tolerance TOLMAG 
+  // (see integrate_GK15), and return number of H(z) evaluations.
+  // int da/(a^2 H) = int dz/H, so use cumulative table if the 
+  // corresponding z-range is covered, or closed form for LCDM.
+
+  double sum ;
+  INTEG_PAR_COSMO_DEF PAR ;
+
+  *NEVAL = 0 ;
+
+  if ( HzFUN_INFO->USE_TABLE && amin > 0.0 && amin <= 1.0 && 
+       amax > 0.0 && amax <= 1.0 &&
+       (1.0/amin - 1.0) <= HzFUN_INFO->zmax_TABLE &&
+       (1.0/amax - 1.0) <= HzFUN_INFO->zmax_TABLE ) {
+    sum = DC_TABLE_interp(1.0/amin - 1.0, HzFUN_INFO) - 
+      DC_TABLE_interp(1.0/amax - 1.0, HzFUN_INFO) ;
+  }
+  else if ( HzFUN_INFO->USE_LCDM_CLOSED && amin > 0.0 && amin <= 1.0 &&
+	    amax > 0.0 && amax <= 1.0 ) {
+    sum = DC_LCDM_closed(1.0/amax - 1.0, 1.0/amin - 1.0, HzFUN_INFO);
+  }
+  else {
+    PAR.HzFUN_INFO = HzFUN_INFO ;
+    PAR.OPT        = 0 ;
+    sum = integrate_GK15(integrand_Hainv, &PAR, amin, amax, TOLMAG, NEVAL);
+  }
+
+  // apply curvature and c/H0 factor
+  return Hzinv_curvature(sum, HzFUN_INFO) ;
+
+} // end of Hainv_integral_tol
+
+
+// ******************************************
+double Hzinv_curvature(double sum, const HzFUN_INFO_DEF *HzFUN_INFO) {
+
+  // Created Oct 2026 [extracted from Hzinv_integral]
+  // Input sum = int H0/H(z) dz is the dimensionless line-of-sight
+  // comoving distance; apply curvature and return transverse
+  // comoving distance in Mpc, including c/H0 factor.
+
+  double H0 = HzFUN_INFO->COSPAR_LIST[ICOSPAR_HzFUN_H0];
+  double OM = HzFUN_INFO->COSPAR_LIST[ICOSPAR_HzFUN_OM];
+  double OL = HzFUN_INFO->COSPAR_LIST[ICOSPAR_HzFUN_OL];
+  double Hzinv, KAPPA, SQRT_KAPPA ;
+
+  // check for curvature
+  KAPPA      = 1.0 - OM - OL ; 
+  SQRT_KAPPA = sqrt(fabs(KAPPA));
+
+  if ( KAPPA < -0.00001 ) 
+    { Hzinv = sin( SQRT_KAPPA * sum ) / SQRT_KAPPA ; }
+  else if ( KAPPA > 0.00001 ) 
+    { Hzinv = sinh( SQRT_KAPPA * sum ) / SQRT_KAPPA ; }
+  else
+    { Hzinv = sum ; }
+
+  // return Hzinv with c/H0 factor
+  return (Hzinv * LIGHT_km / H0 ) ;
+
+} // end of Hzinv_curvature
+
+
+// ******************************************
+double Hzinv_curvature_deriv(double sum, const HzFUN_INFO_DEF *HzFUN_INFO) {
+
+  // Created Oct 2026
+  // Return d/dsum of the curvature function in Hzinv_curvature,
+  // i.e., cos, cosh or 1. Same KAPPA thresholds.
+
+  double OM = HzFUN_INFO->COSPAR_LIST[ICOSPAR_HzFUN_OM];
+  double OL = HzFUN_INFO->COSPAR_LIST[ICOSPAR_HzFUN_OL];
+  double KAPPA      = 1.0 - OM - OL ; 
+  double SQRT_KAPPA = sqrt(fabs(KAPPA));
+
+  if ( KAPPA < -0.00001 ) 
+    { return cos( SQRT_KAPPA * sum ) ; }
+  else if ( KAPPA > 0.00001 ) 
+    { return cosh( SQRT_KAPPA * sum ) ; }
+  else
+    { return 1.0 ; }
+
+} // end of Hzinv_curvature_deriv
+
+
+// ******************************************
+double Hzinv_sum_grad(double zmin, double zmax, 
+		      const HzFUN_INFO_DEF *HzFUN_INFO, double *GRAD) {
+
+  // Created Oct 2026
+  // Return sum = int_zmin^zmax H0/H(z) dz (analytic wCDM only), and
+  // GRAD[ICOSPAR_HzFUN_XXX] = d(sum)/d(COSPAR) accumulated in the 
+  // same quadrature pass; GRAD[H0] = 0. With E^2 = (H/H0)^2,
+  //    d(1/E)/dp = -dE^2/dp / (2 E^3),  Z=1+z, ZL = DE term, and
+  //    dE^2/dOM = Z^3 - Z^2   
+  //    dE^2/dOL = ZL  - Z^2   
+  //    dE^2/dw0 = OL*ZL*3*ln(Z)
+  //    dE^2/dwa = OL*ZL*(3*ln(Z) - 3*z/Z)
+  // Quadrature is NGL_HzFUN-point Gauss-Legendre in bins of at most
+  // DZBIN_GRAD (error < 1E-12 for smooth H).
+
+  double DZBIN_GRAD = 0.05 ;
+  double OM = HzFUN_INFO->COSPAR_LIST[ICOSPAR_HzFUN_OM] ;
+  double OL = HzFUN_INFO->COSPAR_LIST[ICOSPAR_HzFUN_OL] ;
+  double w0 = HzFUN_INFO->COSPAR_LIST[ICOSPAR_HzFUN_w0] ;
+  double wa = HzFUN_INFO->COSPAR_LIST[ICOSPAR_HzFUN_wa] ;
+  double KAPPA = 1.0 - OM - OL ;
+  bool   IS_LCDM = ( w0 == -1.0 && wa == 0.0 ) ;
+  const double *xGL = xGL_HzFUN, *wGL = wGL_HzFUN ;
+  double dz, z, ZZ, Z2, Z3, lnZ, ZL, E2, Einv, W, F, sum = 0.0 ;
+  int    Nbin, ibin, igl, ipar ;
+  char fnam[] = "Hzinv_sum_grad" ;
+  char c1loc[200], c2loc[200] ; // local msg for thread safety
+
+  // ------------ BEGIN -------------
+
+  if ( HzFUN_INFO->USE_MAP ) {
+    sprintf(c1loc,"Cannot compute COSPAR gradient for H(z) map");
+    sprintf(c2loc,"Gradient requires analytic wCDM cosmology.");
+    errmsg(SEV_FATAL, 0, fnam, c1loc, c2loc);
+  }
+
+  for(ipar=0; ipar < NCOSPAR_HzFUN; ipar++ ) { GRAD[ipar] = 0.0 ; }
+  if ( zmax <= zmin ) { return 0.0 ; }
+
+  Nbin = (int)ceil( (zmax-zmin)/DZBIN_GRAD );
+  dz   = (zmax-zmin) / (double)Nbin ;
+
+  for(ibin=0; ibin < Nbin; ibin++ ) {
+    for(igl=0; igl < NGL_HzFUN; igl++ ) {
+      z    = zmin + dz*((double)ibin + 0.5 + 0.5*xGL[igl]) ;
+      W    = 0.5 * dz * wGL[igl] ;
+      ZZ   = 1.0 + z ;  Z2 = ZZ*ZZ ;  Z3 = Z2*ZZ ;  lnZ = log(ZZ) ;
+      if ( IS_LCDM ) 
+	{ ZL = 1.0 ; }
+      else
+	{ ZL = exp( 3.0*(1.0+w0+wa)*lnZ - 3.0*wa*z/ZZ ) ; }
+      E2   = OM*Z3 + KAPPA*Z2 + OL*ZL ;
+      Einv = 1.0 / sqrt(E2) ;
+      F    = -0.5 * W * Einv / E2 ;   // d(1/E)/dE^2, times weight
+      sum                    += W * Einv ;
+      GRAD[ICOSPAR_HzFUN_OM] += F * ( Z3 - Z2 ) ;
+      GRAD[ICOSPAR_HzFUN_OL] += F * ( ZL - Z2 ) ;
+      GRAD[ICOSPAR_HzFUN_w0] += F * OL * ZL * 3.0 * lnZ ;
+      GRAD[ICOSPAR_HzFUN_wa] += F * OL * ZL * 3.0 * ( lnZ - z/ZZ ) ;
+    }
+  }
+
+  return sum ;
+
+} // end Hzinv_sum_grad
+
+
+// ******************************************
+double Hzinv_integral_grad(double zmin, double zmax, 
+			   const HzFUN_INFO_DEF *HzFUN_INFO, double *GRAD) {
+
+  // Created Oct 2026
+  // Same as Hzinv_integral (transverse comoving distance, Mpc), 
+  // and also return GRAD[ICOSPAR_HzFUN_XXX] = d(distance)/d(COSPAR).
+  // Curvature KAPPA = 1-OM-OL contributes dS/dKAPPA to the OM and OL
+  // derivatives, where S(D) = sin(sD)/s, sinh(sD)/s or D, s=sqrt|KAPPA|;
+  // for |KAPPA| below threshold, dS/dKAPPA = D^3/6 (flat limit).
+
+  double H0 = HzFUN_INFO->COSPAR_LIST[ICOSPAR_HzFUN_H0] ;
+  double OM = HzFUN_INFO->COSPAR_LIST[ICOSPAR_HzFUN_OM] ;
+  double OL = HzFUN_INFO->COSPAR_LIST[ICOSPAR_HzFUN_OL] ;
+  double KAPPA = 1.0 - OM - OL ;
+  double s = sqrt(fabs(KAPPA)) ;
+  double cH0 = LIGHT_km / H0 ;
+  double D, r, dSdD, dSdK, GRAD_D[NCOSPAR_HzFUN] ;
+  int    ipar ;
+
+  // ------------ BEGIN -------------
+
+  D    = Hzinv_sum_grad(zmin, zmax, HzFUN_INFO, GRAD_D);
+  r    = Hzinv_curvature(D, HzFUN_INFO) ;
+  dSdD = Hzinv_curvature_deriv(D, HzFUN_INFO) ;
+
+  if ( KAPPA < -0.00001 ) 
+    { dSdK = -( D*cos(s*D)/s - sin(s*D)/(s*s) ) / (2.0*s) ; }
+  else if ( KAPPA > 0.00001 ) 
+    { dSdK =  ( D*cosh(s*D)/s - sinh(s*D)/(s*s) ) / (2.0*s) ; }
+  else
+    { dSdK = D*D*D / 6.0 ; }
+
+  for(ipar=0; ipar < NCOSPAR_HzFUN; ipar++ ) 
+    { GRAD[ipar] = cH0 * dSdD * GRAD_D[ipar] ; }
+
+  // dKAPPA/dOM = dKAPPA/dOL = -1
+  GRAD[ICOSPAR_HzFUN_OM] -= cH0 * dSdK ;
+  GRAD[ICOSPAR_HzFUN_OL] -= cH0 * dSdK ;
+  GRAD[ICOSPAR_HzFUN_H0]  = -r / H0 ;
+
+  return r ;
+
+} // end Hzinv_integral_grad
+
+
+// ******************************************
+double integrate_GK15(INTEG_FUN_DEF FUN, void *PAR, 
+		      double xmin, double xmax, double TOLMAG, int *NEVAL) {
+
+  // Created Oct 2026
+  // Globally adaptive Gauss-Kronrod (7-point Gauss, 15-point Kronrod)
+  // integration of FUN from xmin to xmax. The interval with largest
+  // error estimate |K15-G7| is bisected until the summed error is
+  // below the relative tolerance 
+  //     TOLREL = TOLMAG * ln(10)/5 
+  // i.e., TOLMAG is the requested precision expressed as a 
+  // distance-modulus error in mag. FUN is a batch integrand that
+  // receives the 15 (or 30) Kronrod nodes in one call.
+  //
+  // Returns integral; NEVAL = number of integrand evaluations.
+  // If MXINTERVAL_GK15 is reached, return best estimate.
+
+  static const double XGK[8] = {
+    0.991455371120812639206854697526329, 0.949107912342758524526189684047851,
+    0.864864423359769072789712788640926, 0.741531185599394439863864773280788,
+    0.586087235467691130294144845693013, 0.405845151377397166906606412076961,
+    0.207784955007898467600689403773245, 0.000000000000000000000000000000000 
+  } ;
+  static const double WGK[8] = {
+    0.022935322010529224963732008058970, 0.063092092629978553290700663189204,
+    0.104790010322250183839876322541518, 0.140653259715525918745189590510238,
+    0.169004726639267902826583426598550, 0.190350578064785409913256402421014,
+    0.204432940075298892414161999234649, 0.209482141084727828012999174891714
+  } ;
+  static const double WG[4] = {   // Gauss weights for XGK[1,3,5,7]
+    0.129484966168869693270611432679082, 0.279705391489276667901467771423780,
+    0.381830050505118944950369775488975, 0.417959183673469387755102040816327
+  } ;
+
+  double TOLREL = TOLMAG * log(10.0) / 5.0 ;
+  double A[MXINTERVAL_GK15], B[MXINTERVAL_GK15];
+  double RES[MXINTERVAL_GK15], ERR[MXINTERVAL_GK15];
+  double x[30], f[30], res2[2], err2[2] ;
+  double a, b, c, h, sumK, sumG, restot, errtot, comp, t ;
+  int    NINT, i, j, k, imax, n2 ;
+
+  // ------------ BEGIN ------------
+
+  *NEVAL = 0 ;
+  if ( xmax == xmin ) { return 0.0 ; }
+
+  A[0] = xmin;  B[0] = xmax;  NINT = 1;  imax = 0 ;
+
+  while ( 1 ) {
+
+    // evaluate the new interval(s): first pass is [xmin,xmax];
+    // afterwards the two halves of interval imax.
+    n2 = ( NINT == 1 && *NEVAL == 0 ) ? 1 : 2 ;
+    for(i=0; i < n2; i++ ) {
+      k = ( i == 0 ) ? imax : NINT-1 ;
+      c = 0.5*(A[k] + B[k]) ;   h = 0.5*(B[k] - A[k]) ;
+      for(j=0; j < 7; j++ ) {
+	x[15*i + 2*j+0] = c - h*XGK[j] ;
+	x[15*i + 2*j+1] = c + h*XGK[j] ;
+      }
+      x[15*i + 14] = c ;
+    }
+    FUN(15*n2, x, PAR, f);
+    *NEVAL += 15*n2 ;
+
+    for(i=0; i < n2; i++ ) {
+      k = ( i == 0 ) ? imax : NINT-1 ;
+      h = 0.5*(B[k] - A[k]) ;
+      sumK = WGK[7] * f[15*i+14] ;
+      sumG = WG[3]  * f[15*i+14] ;
+      for(j=0; j < 7; j++ ) {
+	sumK += WGK[j] * ( f[15*i+2*j] + f[15*i+2*j+1] ) ;
+	if ( j%2 == 1 ) 
+	  { sumG += WG[j/2] * ( f[15*i+2*j] + f[15*i+2*j+1] ); }
+      }
+      res2[i] = h * sumK ;
+      err2[i] = fabs(h * (sumK - sumG)) ;
+    }
+    RES[imax] = res2[0];  ERR[imax] = err2[0] ;
+    if ( n2 == 2 ) { RES[NINT-1] = res2[1];  ERR[NINT-1] = err2[1]; }
+
+    // sum over intervals and find interval with largest error;
+    // compensated (Neumaier) sum so that round-off does not limit
+    // the REFERENCE tier.
+    restot = errtot = comp = 0.0 ;  imax = 0 ;
+    for(i=0; i < NINT; i++ ) {
+      t = restot + RES[i] ;
+      if ( fabs(restot) >= fabs(RES[i]) ) 
+	{ comp += (restot - t) + RES[i] ; }
+      else
+	{ comp += (RES[i] - t) + restot ; }
+      restot = t ;  errtot += ERR[i];
+      if ( ERR[i] > ERR[imax] ) { imax = i; }
+    }
+    restot += comp ;
+
+    if ( errtot <= TOLREL * fabs(restot) ) { break; }
+    if ( NINT >= MXINTERVAL_GK15 )          { break; }
+
+    // bisect interval imax; right half goes to the end of the list
+    a = A[imax];  b = B[imax];
+    B[imax] = 0.5*(a+b) ;
+    A[NINT] = 0.5*(a+b) ;   B[NINT] = b ;
+    NINT++ ;
+  }
+
+  return restot ;
+
+} // end integrate_GK15
+
+
+// ******************************************
+// Batch integrands for integrate_GK15; PAR -> INTEG_PAR_COSMO_DEF
+
+void integrand_Hzinv(int N, double *z, void *PAR, double *f) {
+  // f = H0/H(z)
+  const HzFUN_INFO_DEF *HzFUN_INFO = ((INTEG_PAR_COSMO_DEF*)PAR)->HzFUN_INFO;
+  double H0 = HzFUN_INFO->COSPAR_LIST[ICOSPAR_HzFUN_H0];
+  int i;
+  Hzfun_array(N, z, HzFUN_INFO, f);
+  for(i=0; i < N; i++ ) { f[i] = H0 / f[i]; }
+} // end integrand_Hzinv
+
+void integrand_Hainv(int N, double *a, void *PAR, double *f) {
+  // f = H0/(a^2 H(z)),  z = 1/a - 1
+  const HzFUN_INFO_DEF *HzFUN_INFO = ((INTEG_PAR_COSMO_DEF*)PAR)->HzFUN_INFO;
+  double H0 = HzFUN_INFO->COSPAR_LIST[ICOSPAR_HzFUN_H0];
+  double z[30];
+  int i;
+  for(i=0; i < N; i++ ) { z[i] = 1.0/a[i] - 1.0; }
+  Hzfun_array(N, z, HzFUN_INFO, f);
+  for(i=0; i < N; i++ ) { f[i] = H0 / ( f[i] * a[i] * a[i] ); }
+} // end integrand_Hainv
+
+void integrand_SFR(int N, double *a, void *PAR, double *f) {
+  // f = SFR(z) / (a*H(z)),  z = 1/a - 1
+  INTEG_PAR_COSMO_DEF *P = (INTEG_PAR_COSMO_DEF*)PAR ;
+  const HzFUN_INFO_DEF *HzFUN_INFO = P->HzFUN_INFO ;
+  double H0 = HzFUN_INFO->COSPAR_LIST[ICOSPAR_HzFUN_H0];
+  double z[30];
+  int i;
+  for(i=0; i < N; i++ ) { z[i] = 1.0/a[i] - 1.0; }
+  Hzfun_array(N, z, HzFUN_INFO, f);
+  for(i=0; i < N; i++ ) {
+    f[i] = SFRfun_MODEL(z[i], P->SFRMODEL, P->SFRPAR, H0) / ( a[i]*f[i] ); 
+  }
+} // end integrand_SFR
+
+void integrand_dVdz(int N, double *z, void *PAR, double *f) {
+  // f = dV/dz, or z*dV/dz for OPT=1
+  INTEG_PAR_COSMO_DEF *P = (INTEG_PAR_COSMO_DEF*)PAR ;
+  int i;
+  for(i=0; i < N; i++ ) {
+    f[i] = dVdz(z[i], P->HzFUN_INFO);
+    if ( P->OPT == 1 ) { f[i] *= z[i]; }
+  }
+} // end integrand_dVdz
+
+
+
+// ******************************************
+double Hzfun(double zCMB, const HzFUN_INFO_DEF *HzFUN_INFO ) {
+
+  // Driver to return H(zCMB) from analytic wCDM, or from interpolating map.
+  bool   USE_MAP = HzFUN_INFO->USE_MAP ;
+  double Hz ;
+  char fnam[] = "Hzfun" ;
+
+  // ------ returns H(z) -------------
+
+  COSMO_STATS_COUNT(ISTAT_COSMO_Hzfun);
+  COSMO_STATS_NEVAL(1);
+  
+  if ( USE_MAP ) {
+    // interpolate from map read from file.
+    Hz = Hzfun_interp(zCMB, HzFUN_INFO);
+  }
+  else {
+    Hz = Hzfun_wCDM(zCMB, HzFUN_INFO);
+  }
+
+  return Hz ;
+
+} // end of Hzfun
+
+// *************************************************
+double Hzfun_wCDM(double zCMB, const HzFUN_INFO_DEF *HzFUN_INFO) {
+
+  // Created Oct 2020
+  // Refactor using HzFUN_INFO struct, and also use wa.
+  //
+  // July 26 2021: fix awful bug for wa; initially I had assumed
+  //    that integral inside exponent was evaluated numerically,
+  //    but it's not. Include analytic integral.
+
+  double H0 = HzFUN_INFO->COSPAR_LIST[ICOSPAR_HzFUN_H0] ; // km/s/Mpc
+  double OM = HzFUN_INFO->COSPAR_LIST[ICOSPAR_HzFUN_OM] ;
+  double OL = HzFUN_INFO->COSPAR_LIST[ICOSPAR_HzFUN_OL] ;
+  double w0 = HzFUN_INFO->COSPAR_LIST[ICOSPAR_HzFUN_w0] ;
+  double wa = HzFUN_INFO->COSPAR_LIST[ICOSPAR_HzFUN_wa] ;
+  double Hz, sqHz, a, ZZ, Z2, Z3, ZL, KAPPA ;
+  double argpow, argexp ;   
+
+  KAPPA = 1.0 - OM - OL ;  // curvature
+  ZZ    = 1.0 + zCMB ;    Z2=ZZ*ZZ ;   Z3=Z2*ZZ ; 
+  a     = 1.0/ZZ;
+
+  if ( w0 == -1.0 && wa == 0.0 ) 
+    { ZL = 1.0 ; }  // LCDM: skip pow and exp (Oct 2026)
+  else {
+    argpow    =  3.0 * (1.0 + w0 + wa) ;
+    argexp    = -3.0 * wa * zCMB * a ;
+    ZL        = pow(ZZ,argpow) * exp(argexp);
+  }
+
+  sqHz  = OM*Z3  + KAPPA*Z2 + OL*ZL;
+  Hz    = H0 * sqrt ( sqHz ) ;
+  return(Hz);
+
+} // end Hzfun_wCDM
+
+
+// ******************************************
+void Hzfun_array(int NZ, double *zCMB, const HzFUN_INFO_DEF *HzFUN_INFO, 
+		 double *Hz) {
+
+  // Created Oct 2026
+  // Batch version of Hzfun: fill Hz[iz] = H(zCMB[iz]) for NZ redshifts.
+
+  int iz ;
+  COSMO_STATS_NEVAL(NZ);
+  if ( HzFUN_INFO->USE_MAP ) {
+    for(iz=0; iz < NZ; iz++ ) 
+      { Hz[iz] = Hzfun_interp(zCMB[iz], HzFUN_INFO); }
+  }
+  else {
+    Hzfun_wCDM_array(NZ, zCMB, HzFUN_INFO, Hz);
+  }
+
+} // end Hzfun_array
+
+
+// ******************************************
+void Hzfun_wCDM_array(int NZ, double *zCMB, const HzFUN_INFO_DEF *HzFUN_INFO, 
+		      double *Hz) {
+
+  // Created Oct 2026
+  // Batch version of Hzfun_wCDM over contiguous zCMB[NZ] array.
+  // Cosmology params are loaded once per call instead of per z.
+  // For LCDM (w0=-1, wa=0), pow and exp drop out and the remaining 
+  // polynomial + sqrt is evaluated with AVX-512 or AVX2 when the 
+  // cpu supports it (selected at run time), else scalar loop.
+  // For general w0,wa: pow(ZZ,argpow)*exp(argexp) is replaced by a
+  // single exp(argpow*log(ZZ) + argexp).
+
+  double H0 = HzFUN_INFO->COSPAR_LIST[ICOSPAR_HzFUN_H0] ; // km/s/Mpc
+  double OM = HzFUN_INFO->COSPAR_LIST[ICOSPAR_HzFUN_OM] ;
+  double OL = HzFUN_INFO->COSPAR_LIST[ICOSPAR_HzFUN_OL] ;
+  double w0 = HzFUN_INFO->COSPAR_LIST[ICOSPAR_HzFUN_w0] ;
+  double wa = HzFUN_INFO->COSPAR_LIST[ICOSPAR_HzFUN_wa] ;
+  double KAPPA  = 1.0 - OM - OL ;
+  double argpow = 3.0 * (1.0 + w0 + wa) ;
+  double cexp   = -3.0 * wa ;
+  double z, ZZ, Z2, ZL ;
+  int    iz ;
+
+  // ------------ BEGIN ------------
+
+  if ( w0 == -1.0 && wa == 0.0 ) {
+    Hzfun_LCDM_kernel(NZ, zCMB, H0, OM, KAPPA, OL, Hz);
+    return ;
+  }
+
+  for(iz=0; iz < NZ; iz++ ) {
+    z  = zCMB[iz] ;
+    ZZ = 1.0 + z ;   Z2 = ZZ*ZZ ;
+    ZL = exp( argpow*log(ZZ) + cexp*z/ZZ ) ;
+    Hz[iz] = H0 * sqrt( Z2*(OM*ZZ + KAPPA) + OL*ZL ) ;
+  }
+
+} // end Hzfun_wCDM_array
+
+
+// ******************************************
+// LCDM kernels: H = H0*sqrt( Z^2*(OM*Z + KAPPA) + OL ),  Z=1+z.
+// Vector versions are compiled with a per-function target attribute
+// so that the rest of the file does not require -mavx2.
+
+static void Hzfun_LCDM_scalar(int NZ, double *zCMB, double H0, double OM,
+			      double KAPPA, double OL, double *Hz) {
+  int iz; double ZZ ;
+  for(iz=0; iz < NZ; iz++ ) {
+    ZZ     = 1.0 + zCMB[iz] ;
+    Hz[iz] = H0 * sqrt( ZZ*ZZ*(OM*ZZ + KAPPA) + OL ) ;
+  }
+} // end Hzfun_LCDM_scalar
+
+#if defined(__x86_64__) && defined(__GNUC__)
+__attribute__((target("avx2")))
+static void Hzfun_LCDM_avx2(int NZ, double *zCMB, double H0, double OM,
+			    double KAPPA, double OL, double *Hz) {
+  __m256d vONE = _mm256_set1_pd(1.0),  vH0 = _mm256_set1_pd(H0) ;
+  __m256d vOM  = _mm256_set1_pd(OM),   vK  = _mm256_set1_pd(KAPPA) ;
+  __m256d vOL  = _mm256_set1_pd(OL),   vZ, vE2 ;
+  int iz, N4 = NZ - NZ%4 ;
+  for(iz=0; iz < N4; iz += 4 ) {
+    vZ  = _mm256_add_pd(vONE, _mm256_loadu_pd(&zCMB[iz]) );
+    vE2 = _mm256_add_pd(_mm256_mul_pd(vOM,vZ), vK);
+    vE2 = _mm256_mul_pd(vE2, _mm256_mul_pd(vZ,vZ));
+    vE2 = _mm256_add_pd(vE2, vOL);
+    _mm256_storeu_pd(&Hz[iz], _mm256_mul_pd(vH0,_mm256_sqrt_pd(vE2)) );
+  }
+  Hzfun_LCDM_scalar(NZ-N4, &zCMB[N4], H0, OM, KAPPA, OL, &Hz[N4]);
+} // end Hzfun_LCDM_avx2
+
+__attribute__((target("avx512f")))
+static void Hzfun_LCDM_avx512(int NZ, double *zCMB, double H0, double OM,
+			      double KAPPA, double OL, double *Hz) {
+  __m512d vONE = _mm512_set1_pd(1.0),  vH0 = _mm512_set1_pd(H0) ;
+  __m512d vOM  = _mm512_set1_pd(OM),   vK  = _mm512_set1_pd(KAPPA) ;
+  __m512d vOL  = _mm512_set1_pd(OL),   vZ, vE2 ;
+  int iz, N8 = NZ - NZ%8 ;
+  for(iz=0; iz < N8; iz += 8 ) {
+    vZ  = _mm512_add_pd(vONE, _mm512_loadu_pd(&zCMB[iz]) );
+    vE2 = _mm512_add_pd(_mm512_mul_pd(vOM,vZ), vK);
+    vE2 = _mm512_mul_pd(vE2, _mm512_mul_pd(vZ,vZ));
+    vE2 = _mm512_add_pd(vE2, vOL);
+    _mm512_storeu_pd(&Hz[iz], _mm512_mul_pd(vH0,_mm512_sqrt_pd(vE2)) );
+  }
+  Hzfun_LCDM_scalar(NZ-N8, &zCMB[N8], H0, OM, KAPPA, OL, &Hz[N8]);
+} // end Hzfun_LCDM_avx512
+#endif
+
+void Hzfun_LCDM_kernel(int NZ, double *zCMB, double H0, double OM,
+		       double KAPPA, double OL, double *Hz) {
+  // run-time dispatch to widest available instruction set
+#if defined(__x86_64__) && defined(__GNUC__)
+  if ( __builtin_cpu_supports("avx512f") ) 
+    { Hzfun_LCDM_avx512(NZ, zCMB, H0, OM, KAPPA, OL, Hz);  return; }
+  if ( __builtin_cpu_supports("avx2") ) 
+    { Hzfun_LCDM_avx2(NZ, zCMB, H0, OM, KAPPA, OL, Hz);  return; }
+#endif
+  Hzfun_LCDM_scalar(NZ, zCMB, H0, OM, KAPPA, OL, Hz);
+} // end Hzfun_LCDM_kernel
+
+
+// ******************************************
+double Hzfun_interp(double zCMB, const HzFUN_INFO_DEF *HzFUN_INFO) {
+
+    // Oct 2026: interpolate uniform grid from init_HzFUN_MAPGRID
+    //   with direct index computation (was interp_1DFUN on map).
+
+    int    Nzbin  = HzFUN_INFO->Nzbin_GRID ;
+    double dz     = HzFUN_INFO->dz_GRID ;
+    double *HGRID = HzFUN_INFO->Hz_GRID ;
+    double *DGRID = HzFUN_INFO->dHdz_GRID ;
+    double x, t, t1 ;
+    int    iz ;
+    char fnam[] = "Hzfun_interp";
+    char c1loc[200], c2loc[200] ; // local msg for thread safety
+
+    if ( zCMB < 0.0 || zCMB > HzFUN_INFO->zmax_GRID ) {
+      sprintf(c1loc,"zCMB=%f outside H(z) map range 0 to %f", 
+	      zCMB, HzFUN_INFO->zmax_GRID );
+      sprintf(c2loc,"Check H(z) map %s", HzFUN_INFO->FILENAME) ;
+      errmsg(SEV_FATAL, 0, fnam, c1loc, c2loc);
+    }
+
+    x  = zCMB / dz ;
+    iz = (int)x ;
+    if ( iz > Nzbin-2 ) { iz = Nzbin-2; }
+    t  = x - (double)iz ;
+
+    if ( HzFUN_INFO->OPT_INTERP_MAP == OPT_INTERP_HzFUN_MAP_PCHIP ) {
+      t1 = 1.0 - t ;
+      return ( (1.0+2.0*t)*t1*t1*HGRID[iz] + t*t*(3.0-2.0*t)*HGRID[iz+1] +
+	       dz * ( t*t1*t1*DGRID[iz] - t*t*t1*DGRID[iz+1] ) ) ;
+    }
+    else {
+      return ( HGRID[iz] + t*(HGRID[iz+1] - HGRID[iz]) ) ;
+    }
+
+} // end Hzfun_interp
+
+// ******************************************
+double dLmag ( double zCMB, double zHEL, 
+	       const HzFUN_INFO_DEF *HzFUN_INFO, 
+	       const ANISOTROPY_INFO_DEF *ANISOTROPY_INFO  ) {
+	       	       
+  // returns luminosity distance in mags:
+  //   dLmag = 5 * log10(DL/10pc)
+  //
+  // Feb 2023: pass ANISOTROPY_INFO to enable anistropy models
+
+  double rz, dl, arg, mu, zero=0.0 ;
+  double H0, COS_SEP ;
+  // ----------- BEGIN -----------
+
+  COSMO_STATS_BEGIN ;
+
+  if ( ANISOTROPY_INFO->USE_FLAG ) {
+    // Oct 2026: tilted-universe distance depends only on zHEL and
+    //   on cos(angle to apex); skip the isotropic integral.
+    H0      = HzFUN_INFO->COSPAR_LIST[ICOSPAR_HzFUN_H0];
+    COS_SEP = cos_sep_dipole(ANISOTROPY_INFO->GLON, ANISOTROPY_INFO->GLAT,
+			     ANISOTROPY_INFO);
+    mu      = dLmag_dipole(zHEL, COS_SEP, H0, ANISOTROPY_INFO);
+    COSMO_STATS_END(ISTAT_COSMO_dLmag_aniso);
+    return mu ;
+  }
+
+  rz     = Hzinv_integral(zero,zCMB,HzFUN_INFO) ;
+  rz    *= (1.0E6*PC_km);  // H -> 1/sec units
+  dl     = ( 1.0 + zHEL ) * rz ;
+  arg    = dl / (10.0 * PC_km);
+  mu     = 5.0 * log10( arg );
+
+  COSMO_STATS_END(ISTAT_COSMO_dLmag);
+  return mu ;
+}  // end of dLmag
+
+
+// ******************************************
+double dLmag_grad(double zCMB, double zHEL, 
+		  const HzFUN_INFO_DEF *HzFUN_INFO, 
+		  const ANISOTROPY_INFO_DEF *ANISOTROPY_INFO, double *GRAD) {
+
+  // Created Oct 2026
+  // Return same MU as dLmag, and analytic gradient GRAD[NGRAD_dLmag]
+  // ordered as IGRAD_dLmag_XXX: H0, OM, OL, w0, wa, qm, qd, S, J0.
+  // Isotropic (ANISOTROPY_INFO=NULL or USE_FLAG=false): 
+  //   dMU/dp = 5/ln(10) * dr/dp / r, with dr/dp from Hzinv_integral_grad;
+  //   anisotropy gradients are zero.
+  // Anisotropic (tilted universe, see dLmag_dipole), with
+  //   P = 1 + (1-q)*z/2 - (1 - q - 3q^2 + J0)*z^2/6, 
+  //   q = qm + qd*F*cos(theta), F = exp(-z/S):
+  //   dMU/dH0 = -5/(ln10*H0),  dMU/dp = 5/ln(10) * dP/dp / P,
+  //   and OM,OL,w0,wa gradients are zero.
+
+  double FIVE_LN10 = 5.0 / log(10.0) ;
+  double H0 = HzFUN_INFO->COSPAR_LIST[ICOSPAR_HzFUN_H0] ;
+  double GRAD_r[NCOSPAR_HzFUN], r, mu ;
+  int    ipar ;
+
+  // ------------ BEGIN -------------
+
+  for(ipar=0; ipar < NGRAD_dLmag; ipar++ ) { GRAD[ipar] = 0.0 ; }
+
+  if ( ANISOTROPY_INFO != NULL && ANISOTROPY_INFO->USE_FLAG ) {
+    double qm = ANISOTROPY_INFO->qm ;
+    double qd = ANISOTROPY_INFO->qd ;
+    double S  = ANISOTROPY_INFO->S  ;
+    double J0 = ANISOTROPY_INFO->J0 ;
+    double z  = zHEL ;
+    double c  = cos_sep_dipole(ANISOTROPY_INFO->GLON, ANISOTROPY_INFO->GLAT,
+			       ANISOTROPY_INFO);
+    double F  = exp(-z/S) ;
+    double q  = qm + qd*F*c ;
+    double P  = 1.0 + 0.5*(1.0-q)*z - (1.0/6.0)*(1.0 - q - 3.0*q*q + J0)*z*z;
+    double dPdq = -0.5*z + (1.0 + 6.0*q)*z*z/6.0 ;
+
+    mu = dLmag_dipole(zHEL, c, H0, ANISOTROPY_INFO);
+    GRAD[IGRAD_dLmag_H0] = -FIVE_LN10 / H0 ;
+    GRAD[IGRAD_dLmag_qm] =  FIVE_LN10 * dPdq / P ;
+    GRAD[IGRAD_dLmag_qd] =  FIVE_LN10 * dPdq * F * c / P ;
+    GRAD[IGRAD_dLmag_S]  =  FIVE_LN10 * dPdq * qd * c * F * z/(S*S) / P ;
+    GRAD[IGRAD_dLmag_J0] = -FIVE_LN10 * z*z / (6.0*P) ;
+    return mu ;
+  }
+
+  r  = Hzinv_integral_grad(0.0, zCMB, HzFUN_INFO, GRAD_r) ;  // Mpc
+  mu = 5.0 * log10( (1.0 + zHEL) * r * 1.0E5 ) ;
+  for(ipar=0; ipar < NCOSPAR_HzFUN; ipar++ ) 
+    { GRAD[ipar] = FIVE_LN10 * GRAD_r[ipar] / r ; }
+
+  return mu ;
+
+} // end dLmag_grad
+
+
+// ******************************************
+double dLmag_dmudz(double zCMB,
+		   const HzFUN_INFO_DEF *HzFUN_INFO, double *DMUDZ) {
+
+  // Created Oct 2026
+  // Return isotropic distance modulus for zHEL=zCMB (as in 
+  // zcmb_dLmag_invert), and analytic derivative DMUDZ = dMU/dz:
+  //    MU    = 5*log10[(1+z)*r(z)] + 25
+  //    dr/dz = c/H(z) * C_k(DC)  where C_k = cos, cosh or 1
+  //    dMU/dz = 5/ln(10) * [ 1/(1+z) + (dr/dz)/r ]
+
+  int    NEVAL ;
+  double sum, rz, drdz, mu ;
+
+  sum  = Hzinv_sum(0.0, zCMB, get_TOLMAG_HzFUN(HzFUN_INFO), HzFUN_INFO, 
+		   &NEVAL);
+  rz   = Hzinv_curvature(sum, HzFUN_INFO);
+  drdz = LIGHT_km / Hzfun(zCMB, HzFUN_INFO) * 
+    Hzinv_curvature_deriv(sum, HzFUN_INFO);
+
+  mu      = 5.0 * log10( (1.0 + zCMB) * rz ) + 25.0 ;
+  *DMUDZ  = 5.0/log(10.0) * ( 1.0/(1.0 + zCMB) + drdz/rz ) ;
+  return mu ;
+
+} // end dLmag_dmudz
+
+
+// ******************************************
+int sort_zCMB_compare(const void *p1, const void *p2) {
+  // qsort comparator for SORT_zCMB_DEF, increasing zCMB
+  double z1 = ((SORT_zCMB_DEF*)p1)->zCMB ;
+  double z2 = ((SORT_zCMB_DEF*)p2)->zCMB ;
+  if ( z1 < z2 ) { return -1; }
+  if ( z1 > z2 ) { return +1; }
+  return 0;
+} // end sort_zCMB_compare
+
+
+// ******************************************
+int Hzinv_nodes_sorted(int NZ, const SORT_zCMB_DEF *SORT, 
+		       double **zNODE, double **wNODE, int *IEND) {
+
+  // Created Oct 2026
+  // For NZ redshifts SORT[] sorted by increasing zCMB, return number 
+  // of quadrature nodes, and allocate/fill *zNODE and *wNODE such that
+  //    int_0^SORT[o].zCMB f(z) dz = sum_{inode < IEND[o]} wNODE*f(zNODE)
+  // Nodes are 2-point Gauss-Legendre in bins of at most 
+  // DZBIN_SEGMENT_HzFUN between successive sorted redshifts, so that
+  // one running sum covers all redshifts. Negative zCMB have no 
+  // nodes (IEND=0); caller must treat them separately.
+  // Calling function must free *zNODE and *wNODE.
+
+  double GL2 = 0.5/sqrt(3.0) ;
+  double z0, z1, dz, zmid, *zN, *wN ;
+  int    o, ibin, Nbin, NNODE, MXNODE ;
+
+  // --------------- BEGIN ---------------
+
+  // count, then fill quadrature nodes
+  MXNODE = 0 ;  z0 = 0.0 ;
+  for(o=0; o < NZ; o++ ) {
+    z1 = SORT[o].zCMB ;
+    if ( z1 > z0 ) 
+      { MXNODE += 2*(int)ceil((z1-z0)/DZBIN_SEGMENT_HzFUN);  z0 = z1; }
+  }
+  if ( MXNODE < 1 ) { MXNODE = 1; }
+  zN = (double*) malloc( MXNODE * sizeof(double) );
+  wN = (double*) malloc( MXNODE * sizeof(double) );
+
+  NNODE = 0 ;  z0 = 0.0 ;
+  for(o=0; o < NZ; o++ ) {
+    z1 = SORT[o].zCMB ;
+    if ( z1 > z0 ) {
+      Nbin = (int)ceil( (z1-z0)/DZBIN_SEGMENT_HzFUN );
+      dz   = (z1-z0) / (double)Nbin ;
+      for(ibin=0; ibin < Nbin; ibin++ ) {
+	zmid = z0 + dz*((double)ibin + 0.5) ;
+	zN[NNODE] = zmid - dz*GL2 ;  wN[NNODE] = 0.5*dz ;  NNODE++ ;
+	zN[NNODE] = zmid + dz*GL2 ;  wN[NNODE] = 0.5*dz ;  NNODE++ ;
+      }
+      z0 = z1 ;
+    }
+    IEND[o] = ( z1 < 0.0 ) ? 0 : NNODE ;
+  }
+
+  *zNODE = zN ;  *wNODE = wN ;
+  return NNODE ;
+
+} // end Hzinv_nodes_sorted
+
+
+// ******************************************
+void dLmag_array(int NOBJ, double *zCMB, double *zHEL, 
+		 const HzFUN_INFO_DEF *HzFUN_INFO, 
+		 const ANISOTROPY_INFO_DEF *ANISOTROPY_INFO, double *MU ) {
+
+  // Created Oct 2026
+  // Batch version of dLmag for a catalog of NOBJ objects.
+  // Inputs zCMB[NOBJ] and zHEL[NOBJ] are plain arrays (not modified)
+  // and output MU[NOBJ] must be allocated by the calling function.
+  // ANISOTROPY_INFO = NULL is treated as isotropic.
+  //
+  // If the cumulative table covers all zCMB, each MU is an O(1)
+  // lookup. Otherwise, sort by zCMB and carry one running integral
+  // of H0/H(z) forward through the sorted list (Hzinv_nodes_sorted),
+  // so that the total cost is a single pass over the z range instead
+  // of one integral from zero per object.
+  // Oct 2026: LCDM without table -> closed form for each object.
+  // Oct 2026: zCMB < 0 (e.g., -9 flag) gives the same result as dLmag
+  //           (NaN) instead of a table lookup.
+
+  double H0  = HzFUN_INFO->COSPAR_LIST[ICOSPAR_HzFUN_H0];
+  double TOLMAG = get_TOLMAG_HzFUN(HzFUN_INFO);
+  bool   USE_ANISO = false ;
+  int    o, iobj, inode, NNODE, NEVAL, *IEND ;
+  double zmax, sum, rz, dl, arg, *zNODE, *wNODE, *HNODE ;
+  SORT_zCMB_DEF *SORT ;
+
+  // --------------- BEGIN ---------------
+
+  if ( NOBJ <= 0 ) { return ; }
+  COSMO_STATS_BEGIN ;
+  if ( ANISOTROPY_INFO != NULL ) { USE_ANISO = ANISOTROPY_INFO->USE_FLAG; }
+
+  // anisotropic distance depends only on zHEL; no integral needed.
+  // All objects share direction GLON,GLAT in ANISOTROPY_INFO; for 
+  // per-object directions use cos_sep_dipole_array + dLmag_dipole_array.
+  if ( USE_ANISO ) {
+    double *COS_SEP = (double*) malloc(NOBJ*sizeof(double));
+    double  cosSep  = cos_sep_dipole(ANISOTROPY_INFO->GLON, 
+				     ANISOTROPY_INFO->GLAT, ANISOTROPY_INFO);
+    for(o=0; o < NOBJ; o++ ) { COS_SEP[o] = cosSep; }
+    dLmag_dipole_array(NOBJ, zHEL, COS_SEP, H0, ANISOTROPY_INFO, MU);
+    free(COS_SEP);
+    COSMO_STATS_END(ISTAT_COSMO_dLmag_array);
+    return ;
+  }
+
+  zmax = zCMB[0];
+  for(o=1; o < NOBJ; o++ ) { if ( zCMB[o] > zmax ) { zmax = zCMB[o]; } }
+
+  if ( (HzFUN_INFO->USE_TABLE && zmax <= HzFUN_INFO->zmax_TABLE) ||
+       HzFUN_INFO->USE_LCDM_CLOSED ) {
+    for(o=0; o < NOBJ; o++ ) {
+      if ( zCMB[o] < 0.0 )
+	{ sum = Hzinv_sum(0.0, zCMB[o], TOLMAG, HzFUN_INFO, &NEVAL); }
+      else if ( HzFUN_INFO->USE_TABLE && zCMB[o] <= HzFUN_INFO->zmax_TABLE )
+	{ sum = DC_TABLE_interp(zCMB[o], HzFUN_INFO); }
+      else
+	{ sum = DC_LCDM_closed(0.0, zCMB[o], HzFUN_INFO); }
+      rz    = Hzinv_curvature(sum, HzFUN_INFO) * (1.0E6*PC_km);
+      dl    = ( 1.0 + zHEL[o] ) * rz ;
+      arg   = dl / (10.0 * PC_km);
+      MU[o] = 5.0 * log10( arg );
+    }
+    COSMO_STATS_END(ISTAT_COSMO_dLmag_array);
+    return ;
+  }
+
+  // - - - - sorted single-pass integration - - - - 
+  SORT = (SORT_zCMB_DEF*) malloc( NOBJ * sizeof(SORT_zCMB_DEF) );
+  IEND = (int*) malloc( NOBJ * sizeof(int) );
+  for(o=0; o < NOBJ; o++ ) { SORT[o].zCMB = zCMB[o];  SORT[o].INDEX = o; }
+  qsort(SORT, NOBJ, sizeof(SORT_zCMB_DEF), sort_zCMB_compare);
+
+  NNODE = Hzinv_nodes_sorted(NOBJ, SORT, &zNODE, &wNODE, IEND);
+  HNODE = (double*) malloc( (NNODE+1) * sizeof(double) );
+  Hzfun_array(NNODE, zNODE, HzFUN_INFO, HNODE);
+
+  sum = 0.0 ;  inode = 0 ;
+  for(o=0; o < NOBJ; o++ ) {
+    iobj = SORT[o].INDEX ;
+
+    if ( SORT[o].zCMB < 0.0 ) {
+      double sum1 = Hzinv_sum(0.0, SORT[o].zCMB, TOLMAG, HzFUN_INFO, &NEVAL);
+      rz       = Hzinv_curvature(sum1, HzFUN_INFO) * (1.0E6*PC_km);
+      MU[iobj] = 5.0 * log10( (1.0 + zHEL[iobj]) * rz / (10.0 * PC_km) );
+      continue ;
+    }
+
+    for( ; inode < IEND[o]; inode++ ) 
+      { sum += wNODE[inode] * H0 / HNODE[inode] ; }
+
+    rz       = Hzinv_curvature(sum, HzFUN_INFO) * (1.0E6*PC_km);
+    dl       = ( 1.0 + zHEL[iobj] ) * rz ;
+    arg      = dl / (10.0 * PC_km);
+    MU[iobj] = 5.0 * log10( arg );
+  }
+
+  free(zNODE);  free(wNODE);  free(HNODE);  free(IEND);  free(SORT);
+  COSMO_STATS_END(ISTAT_COSMO_dLmag_array);
+  return ;
+
+} // end dLmag_array
 
 
 // ******************************************
-double Hzinv_integral(double zmin, double zmax, HzFUN_INFO_DEF *HzFUN_INFO) {
+void dLmag_COSPAR_GRID(int NZ, double *zCMB, double *zHEL, 
+		       int NGRID, double *COSPAR_GRID, double *MU) {
+
+  // Created Oct 2026
+  // Isotropic distance modulus for NZ redshifts at each of NGRID 
+  // analytic wCDM parameter points:
+  //   COSPAR_GRID[igrid*NCOSPAR_HzFUN + ICOSPAR_HzFUN_XXX] = input params
+  //   MU[igrid*NZ + iz] = dLmag(zCMB[iz], zHEL[iz]) for params igrid
+  // MU must be allocated by calling function (NGRID*NZ doubles).
+  //
+  // Redshifts are sorted once, and the quadrature nodes 
+  // (Hzinv_nodes_sorted, as in dLmag_array) are shared by all 
+  // parameter points. Each parameter point then needs only one
+  // batch H(z) evaluation over the nodes and one running sum, with
+  // no tables. Negative zCMB give the same result as dLmag (NaN). 
+  // Parameter points are split across OpenMP threads.
+
+  double *zNODE, *wNODE ;
+  int    *IEND, o, NNODE ;
+  SORT_zCMB_DEF *SORT ;
+
+  // --------------- BEGIN ---------------
+
+  if ( NZ <= 0 || NGRID <= 0 ) { return ; }
+
+  SORT = (SORT_zCMB_DEF*) malloc( NZ * sizeof(SORT_zCMB_DEF) );
+  IEND = (int*) malloc( NZ * sizeof(int) );
+  for(o=0; o < NZ; o++ ) { SORT[o].zCMB = zCMB[o];  SORT[o].INDEX = o; }
+  qsort(SORT, NZ, sizeof(SORT_zCMB_DEF), sort_zCMB_compare);
+
+  NNODE = Hzinv_nodes_sorted(NZ, SORT, &zNODE, &wNODE, IEND);
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+  {
+    double *HNODE = (double*) malloc( (NNODE+1) * sizeof(double) );
+    double *COSPAR, H0, sum, rz, TOLMAG ;
+    int    ig, inode, k, iobj, NEVAL ;
+    HzFUN_INFO_DEF HzFUN_INFO ;
+
+#ifdef _OPENMP
+#pragma omp for schedule(static)
+#endif
+    for(ig=0; ig < NGRID; ig++ ) {
+      COSPAR = &COSPAR_GRID[ig*NCOSPAR_HzFUN] ;
+      set_HzFUN_DEFAULTS(COSPAR, &HzFUN_INFO);
+      TOLMAG = get_TOLMAG_HzFUN(&HzFUN_INFO);
+      H0     = COSPAR[ICOSPAR_HzFUN_H0] ;
+
+      Hzfun_wCDM_array(NNODE, zNODE, &HzFUN_INFO, HNODE);
+
+      sum = 0.0 ;  inode = 0 ;
+      for(k=0; k < NZ; k++ ) {
+	iobj = SORT[k].INDEX ;
+	if ( SORT[k].zCMB < 0.0 ) {
+	  double sum1 = Hzinv_sum(0.0, SORT[k].zCMB, TOLMAG, &HzFUN_INFO, 
+				  &NEVAL);
+	  rz = Hzinv_curvature(sum1, &HzFUN_INFO) ;   // Mpc
+	}
+	else {
+	  for( ; inode < IEND[k]; inode++ ) 
+	    { sum += wNODE[inode] * H0 / HNODE[inode] ; }
+	  rz = Hzinv_curvature(sum, &HzFUN_INFO) ;    // Mpc
+	}
+	MU[ig*NZ+iobj] = 5.0 * log10( (1.0 + zHEL[iobj]) * rz * 1.0E5 );
+      }
+    }
+    free(HNODE);
+  }
 
-  double H0 = HzFUN_INFO->COSPAR_LIST[ICOSPAR_HzFUN_H0];
-  double H0_per_sec = H0 / ( 1.0E6 * PC_km);
-  double OM = HzFUN_INFO->COSPAR_LIST[ICOSPAR_HzFUN_OM];
-  double OL = HzFUN_INFO->COSPAR_LIST[ICOSPAR_HzFUN_OL];
+  free(zNODE);  free(wNODE);  free(IEND);  free(SORT);
+  return ;
 
-  int iz, Nzbin ;
-  double dz, Hz, xz, ztmp, sum, Hzinv, KAPPA, SQRT_KAPPA ; 
+} // end dLmag_COSPAR_GRID
 
-  // ------ return integral c*r(z) = int c*dz/H(z) -------------
-  // Note that D_L = (1+z)*Hzinv_integral
 
-  sum = 0.0;
+// ******************************************
+void init_ANISOTROPY_INFO(ANISOTROPY_INFO_DEF *ANISOTROPY_INFO) {
 
-  Nzbin = (int)( (zmax-zmin) * 1000.0 ) ;
-  if ( Nzbin < 10 ) { Nzbin = 10 ; }
-  dz  = (zmax-zmin) / (double)Nzbin ;      // integration binsize
+  // Created Oct 2026
+  // Set default tilted-universe params (ANISOTROPY_MODEL_XXX) and 
+  // default dipole apex. USE_FLAG is left false; calling function 
+  // sets USE_FLAG, GLON and GLAT, and may overwrite model params.
 
-  for ( iz=0; iz < Nzbin; iz++ ) {
-    xz   = (double)iz ;
-    ztmp = zmin + dz * (xz + 0.5) ;
-    Hz   = Hzfun (ztmp, HzFUN_INFO);
-    sum += (1.0/Hz) ;
-  }
+  ANISOTROPY_INFO->USE_FLAG = false ;
+  ANISOTROPY_INFO->qm   = ANISOTROPY_MODEL_qm ;
+  ANISOTROPY_INFO->qd   = ANISOTROPY_MODEL_qd ;
+  ANISOTROPY_INFO->S    = ANISOTROPY_MODEL_S  ;
+  ANISOTROPY_INFO->J0   = ANISOTROPY_MODEL_J0 ;
+  ANISOTROPY_INFO->S0   = ANISOTROPY_MODEL_S0 ;
+  ANISOTROPY_INFO->GLON = ANISOTROPY_GLON_APEX ;
+  ANISOTROPY_INFO->GLAT = ANISOTROPY_GLAT_APEX ;
+  set_ANISOTROPY_APEX(ANISOTROPY_GLON_APEX, ANISOTROPY_GLAT_APEX, 
+		      ANISOTROPY_INFO);
 
-  // remove H0 factor from inetgral before checking curvature.
+} // end init_ANISOTROPY_INFO
 
-  sum *= (dz * H0) ;
 
-  // check for curvature
-  KAPPA      = 1.0 - OM - OL ; 
-  SQRT_KAPPA = sqrt(fabs(KAPPA));
+// ******************************************
+void set_ANISOTROPY_APEX(double GLON_APEX, double GLAT_APEX,
+			 ANISOTROPY_INFO_DEF *ANISOTROPY_INFO) {
 
-  if ( KAPPA < -0.00001 ) 
-    { Hzinv = sin( SQRT_KAPPA * sum ) / SQRT_KAPPA ; }
-  else if ( KAPPA > 0.00001 ) 
-    { Hzinv = sinh( SQRT_KAPPA * sum ) / SQRT_KAPPA ; }
-  else
-    { Hzinv = sum ; }
+  // Created Oct 2026
+  // Store dipole apex (deg) and its unit vector, and reset the 
+  // precomputed COS_SEP so that it is recomputed on next use.
 
+  double DEG2RAD = PI/180.0 ;
+  double l = GLON_APEX * DEG2RAD, b = GLAT_APEX * DEG2RAD ;
 
-  // return Hzinv with c/H0 factor
-  return (Hzinv * LIGHT_km / H0 ) ;
+  ANISOTROPY_INFO->GLON_APEX   = GLON_APEX ;
+  ANISOTROPY_INFO->GLAT_APEX   = GLAT_APEX ;
+  ANISOTROPY_INFO->XYZ_APEX[0] = cos(b) * cos(l) ;
+  ANISOTROPY_INFO->XYZ_APEX[1] = cos(b) * sin(l) ;
+  ANISOTROPY_INFO->XYZ_APEX[2] = sin(b) ;
+  ANISOTROPY_INFO->GLON_LAST   = -999.0 ;
+  ANISOTROPY_INFO->GLAT_LAST   = -999.0 ;
+  ANISOTROPY_INFO->COS_SEP     =    0.0 ;
 
-} // end of Hzinv_integral
+} // end set_ANISOTROPY_APEX
 
 
 // ******************************************
-double Hainv_integral(double amin, double amax, HzFUN_INFO_DEF *HzFUN_INFO) {
+void set_ANISOTROPY_DIRECTION(double GLON, double GLAT,
+			      ANISOTROPY_INFO_DEF *ANISOTROPY_INFO) {
 
-  // Same as Hzinv_integral, but integrate over a instead of over z.
-  // dz/E(z) :  z=1/a-1   dz = -da/a^2
+  // Created Oct 2026
+  // Set object direction GLON,GLAT (deg) and precompute cos(angle) 
+  // to dipole apex, so that dLmag and zcmb_dLmag_invert use COS_SEP
+  // without trig. Setting GLON,GLAT directly also works, but then
+  // COS_SEP is recomputed on each call.
 
-  double H0 = HzFUN_INFO->COSPAR_LIST[ICOSPAR_HzFUN_H0];
-  double H0_per_sec = H0 / ( 1.0E6 * PC_km);
-  double OM = HzFUN_INFO->COSPAR_LIST[ICOSPAR_HzFUN_OM];
-  double OL = HzFUN_INFO->COSPAR_LIST[ICOSPAR_HzFUN_OL];
+  ANISOTROPY_INFO->GLON      = GLON ;
+  ANISOTROPY_INFO->GLAT      = GLAT ;
+  ANISOTROPY_INFO->GLON_LAST = -999.0 ;  // force computation below
+  ANISOTROPY_INFO->COS_SEP   = cos_sep_dipole(GLON, GLAT, ANISOTROPY_INFO);
+  ANISOTROPY_INFO->GLON_LAST = GLON ;
+  ANISOTROPY_INFO->GLAT_LAST = GLAT ;
 
-  int ia, Nabin ;
-  double da, Hz, xa, atmp, ztmp, tmp, sum, Hzinv, KAPPA, SQRT_KAPPA ; 
-  char fnam[] = "Hainv_integral";
+} // end set_ANISOTROPY_DIRECTION
 
-  // ------ return integral c*r(z) = int c*dz/H(z) -------------
-  // Note that D_L = (1+z)*Hzinv_integral
 
-  sum = 0.0;
+// ******************************************
+bool get_ANISOTROPY_APEX(const ANISOTROPY_INFO_DEF *ANISOTROPY_INFO,
+			 double *XYZ) {
 
-  Nabin = (int)( (amax-amin) * 1000.0 ) ;
-  if ( Nabin < 10 ) { Nabin = 10 ; }
-  da   = (amax-amin) / (double)Nabin ;   // integration binsize
+  // Created Oct 2026
+  // Load XYZ[3] = unit vector to dipole apex and return true.
+  // If apex was never set with init_ANISOTROPY_INFO or 
+  // set_ANISOTROPY_APEX (XYZ_APEX is not a unit vector), load the 
+  // default apex (ANISOTROPY_GLON[GLAT]_APEX) and return false.
 
-  for ( ia=0; ia < Nabin; ia++ ) {
-    xa   = (double)ia ;
-    atmp = amin + da * (xa + 0.5) ;
-    ztmp = 1./atmp - 1.0 ;
-    Hz   = Hzfun (ztmp, HzFUN_INFO);
-    tmp  = 1.0/( Hz * atmp * atmp) ;
-    sum += tmp ;
-  }
+  double DEG2RAD = PI/180.0 ;
+  const double *V = ANISOTROPY_INFO->XYZ_APEX ;
+  double NORM2 = V[0]*V[0] + V[1]*V[1] + V[2]*V[2] ;
+  double l = ANISOTROPY_GLON_APEX * DEG2RAD ;
+  double b = ANISOTROPY_GLAT_APEX * DEG2RAD ;
 
-  // remove H0 factor from inetgral before checking curvature.
+  if ( fabs(NORM2-1.0) < 1.0E-6 ) 
+    { XYZ[0] = V[0];  XYZ[1] = V[1];  XYZ[2] = V[2];  return true ; }
 
-  sum *= (da * H0) ;
+  XYZ[0] = cos(b) * cos(l) ;
+  XYZ[1] = cos(b) * sin(l) ;
+  XYZ[2] = sin(b) ;
+  return false ;
 
-  // check for curvature
-  KAPPA      = 1.0 - OM - OL ; 
-  SQRT_KAPPA = sqrt(fabs(KAPPA));
+} // end get_ANISOTROPY_APEX
 
-  if ( KAPPA < -0.00001 ) 
-    { Hzinv = sin( SQRT_KAPPA * sum ) / SQRT_KAPPA ; }
-  else if ( KAPPA > 0.00001 ) 
-    { Hzinv = sinh( SQRT_KAPPA * sum ) / SQRT_KAPPA ; }
-  else
-    { Hzinv = sum ; }
 
+// ******************************************
+double cos_sep_dipole(double GLON, double GLAT, 
+		      const ANISOTROPY_INFO_DEF *ANISOTROPY_INFO) {
 
-  // return Hzinv with c/H0 factor
-  return (Hzinv * LIGHT_km / H0 ) ;
+  // Created Oct 2026
+  // Return cos(angle) between direction GLON,GLAT (deg) and dipole apex,
+  // as dot product of unit vectors. If GLON,GLAT matches the direction
+  // from set_ANISOTROPY_DIRECTION, return precomputed COS_SEP.
+  // ANISOTROPY_INFO is not modified, so it can be shared by threads.
 
-} // end of Hainv_integral
+  // Oct 2026: if apex was never set (calling function fills USE_FLAG,
+  //   GLON, GLAT ... directly), use default apex and skip COS_SEP.
 
+  double DEG2RAD = PI/180.0 ;
+  double XYZ[3] ;
+  double l, b, cosb ;
 
+  if ( get_ANISOTROPY_APEX(ANISOTROPY_INFO, XYZ) &&
+       GLON == ANISOTROPY_INFO->GLON_LAST && 
+       GLAT == ANISOTROPY_INFO->GLAT_LAST ) 
+    { return ANISOTROPY_INFO->COS_SEP ; }
 
-// ******************************************
-double Hzfun(double zCMB, HzFUN_INFO_DEF *HzFUN_INFO ) {
+  l = GLON * DEG2RAD ;  b = GLAT * DEG2RAD ;  cosb = cos(b);
+  return ( XYZ[0]*cosb*cos(l) + XYZ[1]*cosb*sin(l) + XYZ[2]*sin(b) ) ;
 
-  // Driver to return H(zCMB) from analytic wCDM, or from interpolating map.
-  bool   USE_MAP = HzFUN_INFO->USE_MAP ;
-  double Hz ;
-  char fnam[] = "Hzfun" ;
+} // end cos_sep_dipole
 
-  // ------ returns H(z) -------------
-  
-  if ( USE_MAP ) {
-    // interpolate from map read from file.
-    Hz = Hzfun_interp(zCMB, HzFUN_INFO);
-  }
-  else {
-    Hz = Hzfun_wCDM(zCMB, HzFUN_INFO);
-  }
 
-  return Hz ;
+// ******************************************
+void cos_sep_dipole_array(int NOBJ, double *GLON, double *GLAT,
+			  const ANISOTROPY_INFO_DEF *ANISOTROPY_INFO, 
+			  double *COS_SEP) {
+
+  // Created Oct 2026
+  // Batch version of cos_sep_dipole for NOBJ directions; intended to 
+  // be called once per catalog, with COS_SEP[NOBJ] then passed to
+  // dLmag_dipole_array. Cache in ANISOTROPY_INFO is not used.
+
+  double DEG2RAD = PI/180.0 ;
+  double XYZ[3], X0, Y0, Z0 ;
+  double l, b, cosb ;
+  int o;
+
+  get_ANISOTROPY_APEX(ANISOTROPY_INFO, XYZ);
+  X0 = XYZ[0] ;  Y0 = XYZ[1] ;  Z0 = XYZ[2] ;
+
+  for(o=0; o < NOBJ; o++ ) {
+    l = GLON[o] * DEG2RAD ;  b = GLAT[o] * DEG2RAD ;  cosb = cos(b);
+    COS_SEP[o] = X0*cosb*cos(l) + Y0*cosb*sin(l) + Z0*sin(b) ;
+  }
 
-} // end of Hzfun
+} // end cos_sep_dipole_array
 
-// *************************************************
-double Hzfun_wCDM(double zCMB, HzFUN_INFO_DEF *HzFUN_INFO) {
 
-  // Created Oct 2020
-  // Refactor using HzFUN_INFO struct, and also use wa.
+// ******************************************
+double dLmag_dipole(double zHEL, double COS_SEP, double H0,
+		    const ANISOTROPY_INFO_DEF *ANISOTROPY_INFO) {
+
+  // Created Oct 2026 (moved from dLmag)
+  // Taylor expanded luminosity distance for tilted universe,
+  // Model taken from paper  arXiv:gr-qc/0309109v4 
+  //    q  = qm + qd * exp(-zHEL/S) * cos(theta)
+  //    DL = (c*z/H0) * [ 1 + (1-q)*z/2 - (1 - q - 3q^2 + J0)*z^2/6 ]
+  // q is evaluated once (previously 3 calls to q_dipole).
   //
-  // July 26 2021: fix awful bug for wa; initially I had assumed
-  //    that integral inside exponent was evaluated numerically,
-  //    but it's not. Include analytic integral.
+  // Oct 2026: fix units; DL is in Mpc, so convert to units of 10 pc
+  //   (previous DL/(10*PC_km) gave MU offset by -5*log10(1E5*PC_km)).
+  // Oct 2026: return -9 if Taylor expansion gives DL <= 0.
 
-  double H0 = HzFUN_INFO->COSPAR_LIST[ICOSPAR_HzFUN_H0] ; // km/s/Mpc
-  double OM = HzFUN_INFO->COSPAR_LIST[ICOSPAR_HzFUN_OM] ;
-  double OL = HzFUN_INFO->COSPAR_LIST[ICOSPAR_HzFUN_OL] ;
-  double w0 = HzFUN_INFO->COSPAR_LIST[ICOSPAR_HzFUN_w0] ;
-  double wa = HzFUN_INFO->COSPAR_LIST[ICOSPAR_HzFUN_wa] ;
-  double Hz, sqHz, a, ZZ, Z2, Z3, ZL, KAPPA ;
-  double argpow, argexp ;   
+  double qm = ANISOTROPY_INFO->qm ;
+  double qd = ANISOTROPY_INFO->qd ;
+  double S  = ANISOTROPY_INFO->S  ;
+  double J0 = ANISOTROPY_INFO->J0 ;
+  double z  = zHEL, q, dl ;
 
-  KAPPA = 1.0 - OM - OL ;  // curvature
-  ZZ    = 1.0 + zCMB ;    Z2=ZZ*ZZ ;   Z3=Z2*ZZ ; 
-  a     = 1.0/ZZ;
+  q  = qm + qd * exp(-z/S) * COS_SEP ;
+  dl = (LIGHT_km*z/H0) * 
+    ( 1.0 + 0.5*(1.0-q)*z - (1.0/6.0)*(1.0 - q - 3.0*q*q + J0)*z*z ) ;
+  if ( dl <= 0.0 ) { return -9.0 ; }
+  return 5.0 * log10(dl * 1.0E5) ;
 
-  argpow    =  3.0 * (1.0 + w0 + wa) ;
-  argexp    = -3.0 * wa * zCMB * a ;
-  ZL        = pow(ZZ,argpow) * exp(argexp);
+} // end dLmag_dipole
 
-  sqHz  = OM*Z3  + KAPPA*Z2 + OL*ZL;
-  Hz    = H0 * sqrt ( sqHz ) ;
-  return(Hz);
 
-} // end Hzfun_wCDM
+// ******************************************
+void dLmag_dipole_array(int NOBJ, double *zHEL, double *COS_SEP, 
+			double H0, const ANISOTROPY_INFO_DEF *ANISOTROPY_INFO,
+			double *MU) {
+
+  // Created Oct 2026
+  // Batch version of dLmag_dipole for NOBJ objects with precomputed 
+  // COS_SEP[NOBJ] (see cos_sep_dipole_array). The loop has no 
+  // branches or calls other than exp/log, so that it vectorizes 
+  // (e.g., with vector math library at -O3).
+  // Oct 2026: MU=-9 where DL <= 0 (as dLmag_dipole); the select 
+  //   below is a blend, not a branch, so the loop still vectorizes.
+
+  double qm = ANISOTROPY_INFO->qm ;
+  double qd = ANISOTROPY_INFO->qd ;
+  double Sinv = 1.0 / ANISOTROPY_INFO->S ;
+  double J0 = ANISOTROPY_INFO->J0 ;
+  double cH0 = LIGHT_km * 1.0E5 / H0 ;  // c/H0 in units of 10 pc
+  double FIVE_LOG10E = 5.0 / log(10.0) ;
+  double z, q, dl ;
+  int o;
+
+  for(o=0; o < NOBJ; o++ ) {
+    z     = zHEL[o] ;
+    q     = qm + qd * exp(-z*Sinv) * COS_SEP[o] ;
+    dl    = cH0 * z * 
+      ( 1.0 + 0.5*(1.0-q)*z - (1.0/6.0)*(1.0 - q - 3.0*q*q + J0)*z*z ) ;
+    MU[o] = ( dl > 0.0 ) ? FIVE_LOG10E * log(dl) : -9.0 ;
+  }
 
+} // end dLmag_dipole_array
 
-// ******************************************
-double Hzfun_interp(double zCMB, HzFUN_INFO_DEF *HzFUN_INFO) {
 
-    int OPT_INTERP = 1; // 1=linear; 2=quadratic
-    int Nzbin      = HzFUN_INFO->Nzbin_MAP;
-    double *zMAP   = HzFUN_INFO->zCMB_MAP ;   // zCMB array from map
-    double *HzMAP  = HzFUN_INFO->HzFUN_MAP ;  // H(z) array from map
-    double Hz;
-    char fnam[] = "Hzfun_interp";
+// ******************************************
+void init_ANISOTROPY_SKYGRID(int NPIX, double *GLON_PIX, double *GLAT_PIX) {
+
+  // Created Oct 2026
+  // Fill NPIX directions (deg) of a Fibonacci sphere: pixel i is
+  // centered at sin(GLAT) = 1 - (2i+1)/NPIX, with GLON incremented
+  // by the golden angle. Pixels have equal area (4pi/NPIX) and
+  // nearly uniform spacing, ~ sqrt(41253/NPIX) deg.
+
+  double RAD2DEG = 180.0/PI ;
+  double GOLDEN  = 180.0 * (3.0 - sqrt(5.0)) ;  // golden angle (deg)
+  double sinb, lon ;
+  int    ipix ;
+
+  for(ipix=0; ipix < NPIX; ipix++ ) {
+    sinb = 1.0 - (2.0*ipix + 1.0) / (double)NPIX ;
+    lon  = fmod( GOLDEN * (double)ipix, 360.0 ) ;
+    GLON_PIX[ipix] = lon ;
+    GLAT_PIX[ipix] = asin(sinb) * RAD2DEG ;
+  }
 
-    Hz = interp_1DFUN(OPT_INTERP, zCMB, Nzbin, zMAP, HzMAP, fnam);
-    return(Hz);
+} // end init_ANISOTROPY_SKYGRID
 
-} // end Hzfun_interp
 
 // ******************************************
-double dLmag ( double zCMB, double zHEL, 
-	       HzFUN_INFO_DEF *HzFUN_INFO, ANISOTROPY_INFO_DEF *ANISOTROPY_INFO  ) {
-	       	       
-  // returns luminosity distance in mags:
-  //   dLmag = 5 * log10(DL/10pc)
+void scan_ANISOTROPY_SKY(int NOBJ, double *zHEL, double *GLON, double *GLAT,
+			 double *MU, double *MUERR, 
+			 int NPIX, double *GLON_PIX, double *GLAT_PIX,
+			 int NPARSET, double *PARSET, 
+			 const HzFUN_INFO_DEF *HzFUN_INFO,
+			 double *CHI2, double *LNLIKE) {
+
+  // Created Oct 2026
+  // Scan dipole apex of the tilted-universe model (see dLmag_dipole)
+  // over NPIX sky directions GLON_PIX,GLAT_PIX (e.g., from 
+  // init_ANISOTROPY_SKYGRID), for each of NPARSET parameter sets
+  //    PARSET[iset*NPAR_ANISOTROPY_SCAN + IPAR_ANISOTROPY_SCAN_XXX]
+  // with XXX = qm, qd, S, J0. Catalog has NOBJ objects with zHEL,
+  // GLON, GLAT (deg), and observed MU +_ MUERR. H0 is taken from 
+  // HzFUN_INFO (as in dLmag); objects with MUERR <= 0 are skipped.
   //
-  // Feb 2023: pass ANISOTROPY_INFO to enable anistropy models
+  // Output
+  //   CHI2[ipix*NPARSET + iset] = chi2 analytically marginalized over 
+  //      a MU offset (H0 and abs mag):
+  //         chi2 = sum w*r^2 - (sum w*r)^2/sum w ,  r = MU - MU_model
+  //      = CHI2_INVALID_ANISOTROPY_SCAN if DL <= 0 for any object,
+  //        or if all objects are skipped.
+  //   LNLIKE[ipix] = -chi2/2 minimized over parameter sets (profile),
+  //      relative to best pixel (max = 0). Skip if LNLIKE = NULL.
+  //
+  // Per-object unit vectors, log10(cz/H0) and qd*exp(-z/S) for each
+  // parameter set are computed once; each (pixel,set,object) is then
+  // a dot product, a quadratic and one log. Pixels are distributed 
+  // over OpenMP threads.
+
+  double DEG2RAD = PI/180.0 ;
+  double FIVE_LOG10E = 5.0 / log(10.0) ;
+  double H0 = HzFUN_INFO->COSPAR_LIST[ICOSPAR_HzFUN_H0] ;
+  double *XYZ, *LOGCZ, *WGT, *EXPS ;
+  double l, b, z, chi2min ;
+  int    o, iset, ipix, NSKIP = 0 ;
+  char fnam[] = "scan_ANISOTROPY_SKY" ;
+
+  // -------------- BEGIN ----------------
+
+  if ( NOBJ <= 0 || NPIX <= 0 || NPARSET <= 0 ) { return ; }
+
+  XYZ   = (double*) malloc( 3*NOBJ * sizeof(double) );
+  LOGCZ = (double*) malloc(   NOBJ * sizeof(double) );
+  WGT   = (double*) malloc(   NOBJ * sizeof(double) );
+  EXPS  = (double*) malloc( NPARSET*NOBJ * sizeof(double) );
+
+  for(o=0; o < NOBJ; o++ ) {
+    l = GLON[o] * DEG2RAD ;   b = GLAT[o] * DEG2RAD ;
+    XYZ[3*o+0] = cos(b) * cos(l) ;
+    XYZ[3*o+1] = cos(b) * sin(l) ;
+    XYZ[3*o+2] = sin(b) ;
+    if ( MUERR[o] > 0.0 ) {
+      LOGCZ[o] = FIVE_LOG10E * log( LIGHT_km * 1.0E5 * zHEL[o] / H0 ) ;
+      WGT[o]   = 1.0 / (MUERR[o]*MUERR[o]) ;
+    }
+    else
+      { LOGCZ[o] = WGT[o] = 0.0 ;  NSKIP++ ; }
+  }
 
-  double rz, dl, arg, mu, zero=0.0 ;
-  // ----------- BEGIN -----------
-  rz     = Hzinv_integral(zero,zCMB,HzFUN_INFO) ;
-  rz    *= (1.0E6*PC_km);  // H -> 1/sec units
-  dl     = ( 1.0 + zHEL ) * rz ;
-  arg    = dl / (10.0 * PC_km);
-  mu     = 5.0 * log10( arg );
+  if ( NSKIP > 0 ) {
+    printf("\t WARNING: skip %d of %d objects with MUERR <= 0 (%s)\n",
+	   NSKIP, NOBJ, fnam);
+    fflush(stdout);
+  }
 
-  if ( ANISOTROPY_INFO->USE_FLAG ) {
-    H0 = HzFUN_INFO->COSPAR_LIST[ICOSPAR_HzFUN_H0];
-    // xxx for S. Sah to complete
-    //starting the function definition  : Taylor expanded luminosity distance for titlted universe 
-    // Model taken from paper  arXiv:gr-qc/0309109v4 
-    double J0_dipole = ANISOTROPY_INFO->J0;
-    
-    dl= (LIGHT_km*zHEL/H0)*(1.0+1.0/2.0*(1-q_dipole(zHEL,ANISOTROPY_INFO))*zHEL-(1.0/6.0)*(1-q_dipole(zHEL,ANISOTROPY_INFO)-3*pow(q_dipole(zHEL,ANISOTROPY_INFO),2)+J0_dipole)*pow(zHEL,2));
-    arg    = dl / (10.0 * PC_km);
-    mu     = 5.0 * log10( arg );
+  for(iset=0; iset < NPARSET; iset++ ) {
+    double *P = &PARSET[iset*NPAR_ANISOTROPY_SCAN] ;
+    for(o=0; o < NOBJ; o++ ) {
+      z = zHEL[o] ;
+      EXPS[iset*NOBJ+o] = P[IPAR_ANISOTROPY_SCAN_qd] * 
+	exp(-z/P[IPAR_ANISOTROPY_SCAN_S]) ;
+    }
+  }
 
-    
-    
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+  {
+    double *COS_SEP = (double*) malloc( NOBJ * sizeof(double) );
+    double lp, bp, V[3], qm, J0, q, zo, poly, r, w, sw, swr, swrr ;
+    bool   VALID ;
+    int    ip, is, k ;
+
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic,4)
+#endif
+    for(ip=0; ip < NPIX; ip++ ) {
+      lp = GLON_PIX[ip] * DEG2RAD ;   bp = GLAT_PIX[ip] * DEG2RAD ;
+      V[0] = cos(bp) * cos(lp) ;
+      V[1] = cos(bp) * sin(lp) ;
+      V[2] = sin(bp) ;
+      for(k=0; k < NOBJ; k++ ) {
+	COS_SEP[k] = V[0]*XYZ[3*k] + V[1]*XYZ[3*k+1] + V[2]*XYZ[3*k+2] ;
+      }
+
+      for(is=0; is < NPARSET; is++ ) {
+	qm = PARSET[is*NPAR_ANISOTROPY_SCAN + IPAR_ANISOTROPY_SCAN_qm] ;
+	J0 = PARSET[is*NPAR_ANISOTROPY_SCAN + IPAR_ANISOTROPY_SCAN_J0] ;
+	sw = swr = swrr = 0.0 ;  VALID = true ;
+	for(k=0; k < NOBJ; k++ ) {
+	  w    = WGT[k] ;
+	  if ( w == 0.0 ) { continue ; }
+	  zo   = zHEL[k] ;
+	  q    = qm + EXPS[is*NOBJ+k] * COS_SEP[k] ;
+	  poly = 1.0 + 0.5*(1.0-q)*zo - (1.0/6.0)*(1.0-q-3.0*q*q+J0)*zo*zo ;
+	  if ( poly <= 0.0 ) { VALID = false ; break ; }
+	  r     = MU[k] - LOGCZ[k] - FIVE_LOG10E * log(poly) ;
+	  sw   += w ;   swr += w*r ;   swrr += w*r*r ;
+	}
+	if ( sw == 0.0 ) { VALID = false ; }
+	CHI2[ip*NPARSET+is] = VALID ? 
+	  (swrr - swr*swr/sw) : CHI2_INVALID_ANISOTROPY_SCAN ;
+      }
+    }
+    free(COS_SEP);
   }
 
-  return mu ;
-}  // end of dLmag
+  // profile likelihood map
+  if ( LNLIKE != NULL ) {
+    chi2min = CHI2_INVALID_ANISOTROPY_SCAN ;
+    for(ipix=0; ipix < NPIX; ipix++ ) {
+      LNLIKE[ipix] = CHI2_INVALID_ANISOTROPY_SCAN ;
+      for(iset=0; iset < NPARSET; iset++ ) {
+	if ( CHI2[ipix*NPARSET+iset] < LNLIKE[ipix] ) 
+	  { LNLIKE[ipix] = CHI2[ipix*NPARSET+iset]; }
+      }
+      if ( LNLIKE[ipix] < chi2min ) { chi2min = LNLIKE[ipix]; }
+    }
+    for(ipix=0; ipix < NPIX; ipix++ ) 
+      { LNLIKE[ipix] = -0.5 * ( LNLIKE[ipix] - chi2min ) ; }
+  }
+
+  free(XYZ);  free(LOGCZ);  free(WGT);  free(EXPS);
+  return ;
+
+} // end scan_ANISOTROPY_SKY
 
 
 // dipolar q for tilted cosmology
-double F_dipole( double zHEL, ANISOTROPY_INFO_DEF *ANISOTROPY_INFO) {
+double F_dipole( double zHEL, const ANISOTROPY_INFO_DEF *ANISOTROPY_INFO) {
     double S_dipole = ANISOTROPY_INFO->S; 
     return exp(-zHEL/S_dipole);    
     
 }
 
-double angular_separation( ANISOTROPY_INFO_DEF *ANISOTROPY_INFO) {
+double angular_separation( const ANISOTROPY_INFO_DEF *ANISOTROPY_INFO) {
+    // Oct 2026: apex from ANISOTROPY_INFO (was hard-wired);
+    //   default apex if never set (see get_ANISOTROPY_APEX)
+    double XYZ[3];
+    bool   SET  = get_ANISOTROPY_APEX(ANISOTROPY_INFO, XYZ);
     double lon1 = ANISOTROPY_INFO->GLON *PI/180;
     double lat1 = ANISOTROPY_INFO->GLAT *PI/180;
-    double lon2 = 264.021 *PI/180;
-    double lat2 = 48.253*PI/180;
+    double lon2 = ( SET ? ANISOTROPY_INFO->GLON_APEX : 
+		    ANISOTROPY_GLON_APEX ) *PI/180;
+    double lat2 = ( SET ? ANISOTROPY_INFO->GLAT_APEX : 
+		    ANISOTROPY_GLAT_APEX ) *PI/180;
     double dlon = lon2 - lon1;
     double dlat = lat2 - lat1;
     double a = pow(sin(dlat/2), 2) + cos(lat1) * cos(lat2) * pow(sin(dlon/2), 2);
@@ -576,12 +4384,14 @@ double angular_separation( ANISOTROPY_INFO_DEF *ANISOTROPY_INFO) {
     
 }
     
-double q_dipole(double zHEL, ANISOTROPY_INFO_DEF *ANISOTROPY_INFO){
+double q_dipole(double zHEL, const ANISOTROPY_INFO_DEF *ANISOTROPY_INFO){
+    // Oct 2026: use cos_sep_dipole instead of angular_separation
     double q;
     double qd = ANISOTROPY_INFO->qd;
     double qm = ANISOTROPY_INFO->qm;
-    double sep = angular_separation(ANISOTROPY_INFO);
-    q = qm + qd*F_dipole(zHEL,ANISOTROPY_INFO)*cos(sep*PI/180);
+    double cosSep = cos_sep_dipole(ANISOTROPY_INFO->GLON, 
+				   ANISOTROPY_INFO->GLAT, ANISOTROPY_INFO);
+    q = qm + qd*F_dipole(zHEL,ANISOTROPY_INFO)*cosSep;
     return q;
 }
 
@@ -592,20 +4402,29 @@ double dlmag_fortc__(double *zCMB, double *zHEL, double *H0,
   // C interface to fortran;
   // returns luminosity distance in mags:   dLmag = 5 * log10(DL/10pc)
   //
-  double mu;
+  // Oct 2026: use LRU cache of tabulated cosmologies (get_COSMO_CACHE)
+  //
+  double mu, COSPAR[NCOSPAR_HzFUN] = { *H0, *OM, *OL, *w0, *wa } ;
   HzFUN_INFO_DEF HzFUN_INFO ;
   ANISOTROPY_INFO_DEF ANISOTROPY_INFO;
+  COSMO_CACHE_ITEM_DEF *ITEM ;
 
   // ----------- BEGIN -----------
 
-  HzFUN_INFO.COSPAR_LIST[ICOSPAR_HzFUN_H0] = *H0 ;
-  HzFUN_INFO.COSPAR_LIST[ICOSPAR_HzFUN_OM] = *OM ;
-  HzFUN_INFO.COSPAR_LIST[ICOSPAR_HzFUN_OL] = *OL ;
-  HzFUN_INFO.COSPAR_LIST[ICOSPAR_HzFUN_w0] = *w0 ;
-  HzFUN_INFO.COSPAR_LIST[ICOSPAR_HzFUN_wa] = *wa ;
-  HzFUN_INFO.USE_MAP = false ;
-
   ANISOTROPY_INFO.USE_FLAG = false;
+
+  ITEM = get_COSMO_CACHE(COSPAR);
+  if ( ITEM != NULL ) {
+    HzFUN_INFO = *ITEM->HzFUN_INFO ;  // private copy for H0
+    set_HzFUN_H0(*H0, &HzFUN_INFO);
+    mu = dLmag(*zCMB, *zHEL, &HzFUN_INFO, &ANISOTROPY_INFO );
+    release_COSMO_CACHE(ITEM);
+    return mu ;
+  }
+
+  set_HzFUN_DEFAULTS(COSPAR, &HzFUN_INFO);
+  init_HzFUN_LCDM(&HzFUN_INFO);
+
   mu = dLmag(*zCMB, *zHEL, &HzFUN_INFO, &ANISOTROPY_INFO );
 
   /* xxx
@@ -619,19 +4438,101 @@ double dlmag_fortc__(double *zCMB, double *zHEL, double *H0,
 }  // end of dlmag_fort__
 
 
-double zcmb_dLmag_invert( double MU, HzFUN_INFO_DEF *HzFUN_INFO, 
-			  ANISOTROPY_INFO_DEF *ANISOTROPY_INFO) {
+// ******************************************
+double dlmag_grad_fortc__(double *zCMB, double *zHEL, double *H0,
+			  double *OM, double *OL, double *w0, double *wa,
+			  double *GRAD) {
+
+  // Created Oct 2026
+  // C interface to fortran for dLmag_grad (isotropic);
+  // returns MU, and GRAD[5] = dMU/d(H0,OM,OL,w0,wa).
+
+  double mu, GRAD_ALL[NGRAD_dLmag] ;
+  double COSPAR[NCOSPAR_HzFUN] = { *H0, *OM, *OL, *w0, *wa } ;
+  int    ipar ;
+  HzFUN_INFO_DEF HzFUN_INFO ;
+
+  set_HzFUN_DEFAULTS(COSPAR, &HzFUN_INFO);
+  init_HzFUN_LCDM(&HzFUN_INFO);
+
+  mu = dLmag_grad(*zCMB, *zHEL, &HzFUN_INFO, NULL, GRAD_ALL);
+  for(ipar=0; ipar < NCOSPAR_HzFUN; ipar++ ) { GRAD[ipar] = GRAD_ALL[ipar]; }
+  return mu ;
+
+} // end dlmag_grad_fortc__
+
+
+// ******************************************
+void dlmag_array_fortc__(int *NOBJ, double *zCMB, double *zHEL, 
+			 double *H0, double *OM, double *OL, 
+			 double *w0, double *wa, double *MU) {
+
+  // Created Oct 2026
+  // Fortran/Python interface to dLmag_array; caller owns all buffers.
+  // Uses LRU cache of tabulated cosmologies (get_COSMO_CACHE).
+
+  double COSPAR[NCOSPAR_HzFUN] = { *H0, *OM, *OL, *w0, *wa } ;
+  HzFUN_INFO_DEF HzFUN_INFO ;
+  COSMO_CACHE_ITEM_DEF *ITEM ;
+
+  ITEM = get_COSMO_CACHE(COSPAR);
+  if ( ITEM != NULL ) {
+    HzFUN_INFO = *ITEM->HzFUN_INFO ;  // private copy for H0
+    set_HzFUN_H0(*H0, &HzFUN_INFO);
+    dLmag_array(*NOBJ, zCMB, zHEL, &HzFUN_INFO, NULL, MU);
+    release_COSMO_CACHE(ITEM);
+    return ;
+  }
+
+  set_HzFUN_DEFAULTS(COSPAR, &HzFUN_INFO);
+  init_HzFUN_LCDM(&HzFUN_INFO);
+
+  dLmag_array(*NOBJ, zCMB, zHEL, &HzFUN_INFO, NULL, MU);
+
+} // end dlmag_array_fortc__
+
+
+double zcmb_dLmag_invert( double MU, const HzFUN_INFO_DEF *HzFUN_INFO, 
+			  const ANISOTROPY_INFO_DEF *ANISOTROPY_INFO) {
 
   // Created Jan 4 2018
   // for input distance modulus (MU), solve for zCMB.
-
-  double zCMB, zCMB_start, dmu, DMU, mutmp, DL ;
-  double DMU_CONVERGE = 1.0E-4 ;
+  //
+  // Oct 2026: 
+  //  + if MUINV table exists and MU is covered, return O(1) lookup.
+  //  + isotropic: Newton iteration in ln(z) using analytic dMU/dz
+  //    from dLmag_dmudz; converges in a few iterations.
+  //  + anisotropic: secant iteration in ln(z), seeded with the
+  //    original ad-hoc update zCMB *= exp(-dmu/2).
+  //  + REFERENCE tier: converge to quadrature tolerance.
+  //  + MUINV table lookup at MU + DMU_MUINV (see set_HzFUN_H0)
+
+  double zCMB, zCMB_start, dmu, DMU, mutmp, DL, dmudz, MUREF ;
+  double lnz, lnz_last=0.0, dmu_last=0.0 ;
+  double DMU_CONVERGE = DMU_CONVERGE_INVERT ;
+  bool   USE_ANISO = false ;
   int    NITER=0;
   char fnam[] = "zcmb_dLmag_invert" ;
+  char c1loc[200], c2loc[200] ; // local msg for thread safety
 
   // ---------- BEGIN ----------
 
+  COSMO_STATS_BEGIN ;
+
+  if ( ANISOTROPY_INFO != NULL ) { USE_ANISO = ANISOTROPY_INFO->USE_FLAG; }
+  if ( HzFUN_INFO->IPREC == IPREC_HzFUN_REFERENCE ) 
+    { DMU_CONVERGE = 10.0 * TOLMAG_INTEG_REFERENCE ; }
+
+  MUREF = MU + HzFUN_INFO->DMU_MUINV ;
+  if ( !USE_ANISO && HzFUN_INFO->USE_TABLE && HzFUN_INFO->Nbin_MUINV > 0 &&
+       MUREF >= HzFUN_INFO->mumin_MUINV && 
+       MUREF <= HzFUN_INFO->mumax_MUINV ) {
+    zCMB = zcmb_MUINV_interp(MUREF, HzFUN_INFO);
+    COSMO_STATS_NITER(0);
+    COSMO_STATS_END(ISTAT_COSMO_zcmb_invert);
+    return zCMB ;
+  }
+
   // use naive Hubble law to estimate zCMB_start
   DL    = pow( 10.0,(MU/5.0) ) * 1.0E-5 ; // Mpc
   zCMB_start = (70.0*DL)/LIGHT_km ;
@@ -640,33 +4541,68 @@ double zcmb_dLmag_invert( double MU, HzFUN_INFO_DEF *HzFUN_INFO,
   zCMB = zCMB_start ;
   DMU = 9999.0 ;
   while ( DMU > DMU_CONVERGE ) {
-    mutmp  = dLmag(zCMB, zCMB, HzFUN_INFO, ANISOTROPY_INFO ); // MU for trial zCMB
-    dmu    = mutmp - MU ;             // error on mu
-    DMU    = fabs(dmu);
-    zCMB  *= exp(-dmu/2.0); 
 
-    NITER++ ;
     if ( NITER > 500 ) {
-      sprintf(c1err,"Could not solve for zCMB after NITER=%d", NITER);
-      sprintf(c2err,"MU=%f  dmu=%f  ztmp=%f", MU, dmu, zCMB);
-      errmsg(SEV_FATAL, 0, fnam, c1err, c2err);
+      sprintf(c1loc,"Could not solve for zCMB after NITER=%d", NITER);
+      sprintf(c2loc,"MU=%f  dmu=%f  ztmp=%f", MU, dmu, zCMB);
+      errmsg(SEV_FATAL, 0, fnam, c1loc, c2loc);
     }
-  } // end dz                                                                   
 
-  int LDMP=0 ;
-  if ( LDMP ) {
-    printf(" xxx --------------------------------------------- \n");
-    printf(" xxx MU=%.4f -> DL = %.2f Mpc  zCMB(start) = %.5f \n",
-	   MU, DL, zCMB_start );
-    printf(" xxx zCMB -> %.5f  DMU=%f after %d iterations \n",
-	   zCMB, DMU, NITER);
-  }
+    lnz = log(zCMB);
+    if ( USE_ANISO ) {
+      mutmp = dLmag(zCMB, zCMB, HzFUN_INFO, ANISOTROPY_INFO ); 
+      dmu   = mutmp - MU ;
+      if ( (mutmp < 0.0 || !isfinite(dmu)) && NITER > 0 ) {
+	// Taylor-expanded DL <= 0 here (dLmag_dipole returns -9);
+	// back off toward last z
+	zCMB = exp( 0.5*(lnz + lnz_last) );
+	NITER++ ;  continue ;
+      }
+      if ( NITER == 0 || dmu == dmu_last ) 
+	{ zCMB *= exp(-dmu/2.0);  }  // original update
+      else 
+	{ zCMB = exp( lnz - dmu*(lnz-lnz_last)/(dmu-dmu_last) ); }
+      if ( !isfinite(zCMB) || zCMB <= 0.0 ) 
+	{ zCMB = exp(lnz - dmu/2.0); } // secant failed; original update
+    }
+    else {
+      mutmp = dLmag_dmudz(zCMB, HzFUN_INFO, &dmudz); 
+      dmu   = mutmp - MU ;
+      zCMB *= exp( -dmu / (zCMB*dmudz) ) ; 
+    }
+    DMU      = fabs(dmu);
+    lnz_last = lnz ;   dmu_last = dmu ;
 
+    NITER++ ;
+  } // end dz                                                                   
+
+  COSMO_STATS_NITER(NITER);
+  COSMO_STATS_END(ISTAT_COSMO_zcmb_invert);
   return(zCMB);
 
 } // end zcmb_dLmag_invert
 
 
+// ******************************************
+void zcmb_dLmag_invert_array(int NOBJ, double *MU,
+			     const HzFUN_INFO_DEF *HzFUN_INFO,
+			     const ANISOTROPY_INFO_DEF *ANISOTROPY_INFO, 
+			     double *zCMB) {
+
+  // Created Oct 2026
+  // Batch version of zcmb_dLmag_invert: fill zCMB[NOBJ] for input
+  // MU[NOBJ]. For isotropic cosmology, the mu->z table built once
+  // per cosmology in init_HzFUN_INFO gives each zCMB as an O(1) 
+  // lookup; objects outside the table (or anisotropic) are solved
+  // individually with zcmb_dLmag_invert.
+
+  int o;
+  for(o=0; o < NOBJ; o++ ) 
+    { zCMB[o] = zcmb_dLmag_invert(MU[o], HzFUN_INFO, ANISOTROPY_INFO); }
+
+} // end zcmb_dLmag_invert_array
+
+
 
 // ************************************************
 double zhelio_zcmb_translator (double z_input, double RA, double DEC, 
@@ -703,6 +4639,7 @@ double zhelio_zcmb_translator (double z_input, double RA, double DEC,
 
   double  ra_gal, dec_gal, ss, ccc, c1, c2, c3, vdotn, z_out  ;
   char fnam[] = "zhelio_zcmb_translator" ;
+  char c1loc[200], c2loc[200] ; // local msg for thread safety
 
   // --------------- BEGIN ------------
 
@@ -710,6 +4647,8 @@ double zhelio_zcmb_translator (double z_input, double RA, double DEC,
   // no calculation. Allows flags such as -9 to be unperturbed.
   if ( z_input < 1.0E-10 ) { return z_input ; }
 
+  COSMO_STATS_BEGIN ;
+
   if ( strcmp(coordSys,"eq"   ) == 0 || 
        strcmp(coordSys,"J2000") == 0 ) {
 
@@ -721,9 +4660,9 @@ double zhelio_zcmb_translator (double z_input, double RA, double DEC,
     dec_gal = DEC ;
   }
   else {
-    sprintf(c1err,"Invalid coordSys = '%s' ", coordSys );
-    sprintf(c2err,"OPT=%d z_in=%f RA=%f DEC=%f", OPT, z_input, RA, DEC);
-    errmsg(SEV_FATAL, 0, fnam, c1err, c2err );
+    sprintf(c1loc,"Invalid coordSys = '%s' ", coordSys );
+    sprintf(c2loc,"OPT=%d z_in=%f RA=%f DEC=%f", OPT, z_input, RA, DEC);
+    errmsg(SEV_FATAL, 0, fnam, c1loc, c2loc );
   }
 
   // get projection
@@ -744,20 +4683,410 @@ double zhelio_zcmb_translator (double z_input, double RA, double DEC,
     z_out  = ( 1. + z_input) * ( 1. - vdotn ) - 1.0 ;  
   }
   else if ( OPT == 0 ) {
-    sprintf(c1err,"Invalid OPT=0" );
-    sprintf(c2err,"z_input=%f  RA=%f  DEC=%f", z_input,RA,DEC);
-    errmsg(SEV_FATAL, 0, fnam, c1err, c2err);
+    sprintf(c1loc,"Invalid OPT=0" );
+    sprintf(c2loc,"z_input=%f  RA=%f  DEC=%f", z_input,RA,DEC);
+    errmsg(SEV_FATAL, 0, fnam, c1loc, c2loc);
   }
-   
+
+  COSMO_STATS_END(ISTAT_COSMO_zhelio_zcmb);
   return(z_out) ;
 
 } // end of zhelio_zcmb_translator 
 
+// ************************************************
+int index_COORDSYS(char *coordSys) {
+  // Created Oct 2026
+  // Translate coordSys string to ICOORDSYS_XXX index, so that
+  // batch functions parse the string once per catalog.
+  char fnam[] = "index_COORDSYS" ;
+  if ( strcmp(coordSys,"eq"   ) == 0 || 
+       strcmp(coordSys,"J2000") == 0 ) { return ICOORDSYS_EQ ; }
+  if ( strcmp(coordSys,"gal") == 0 )   { return ICOORDSYS_GAL ; }
+
+  sprintf(c1err,"Invalid coordSys = '%s' ", coordSys );
+  sprintf(c2err,"Valid coordSys are eq, J2000, gal");
+  errmsg(SEV_FATAL, 0, fnam, c1err, c2err );
+  return -9 ;
+} // end index_COORDSYS
+
+
+// J2000 equatorial -> IAU 1958 galactic (same matrix as slaEqgal)
+static const double RMAT_EQGAL[3][3] = {
+  { -0.054875539726, -0.873437108010, -0.483834985808 },
+  { +0.494109453312, -0.444829589425, +0.746982251810 },
+  { -0.867666135858, -0.198076386122, +0.455983795705 } 
+};
+
+// ************************************************
+void galvec_to_COORDSYS(int ICOORDSYS, const double *VGAL, double *V) {
+
+  // Created Oct 2026
+  // Express galactic-frame vector VGAL in coordinate system ICOORDSYS;
+  // for ICOORDSYS_EQ, rotate with transpose of RMAT_EQGAL so that
+  // V.nhat_eq = VGAL.nhat_gal.
+
+  int i;
+  char fnam[] = "galvec_to_COORDSYS" ;
+  char c1loc[200], c2loc[200] ; // local msg for thread safety
+
+  if ( ICOORDSYS == ICOORDSYS_EQ ) {
+    for(i=0; i < 3; i++ ) {
+      V[i] = RMAT_EQGAL[0][i]*VGAL[0] + RMAT_EQGAL[1][i]*VGAL[1] + 
+	RMAT_EQGAL[2][i]*VGAL[2] ;
+    }
+  }
+  else if ( ICOORDSYS == ICOORDSYS_GAL ) {
+    for(i=0; i < 3; i++ ) { V[i] = VGAL[i]; }
+  }
+  else {
+    sprintf(c1loc,"Invalid ICOORDSYS = %d", ICOORDSYS );
+    sprintf(c2loc,"See ICOORDSYS_XXX in sntools_cosmology.h");
+    errmsg(SEV_FATAL, 0, fnam, c1loc, c2loc );
+  }
+
+} // end galvec_to_COORDSYS
+
+
+// ************************************************
+void zhelio_zcmb_translator_array(int NOBJ, double *z_input, 
+				  double *RA, double *DEC, 
+				  int ICOORDSYS, int OPT, double *z_out) {
+
+  // Created Oct 2026
+  // Batch version of zhelio_zcmb_translator for NOBJ objects:
+  //   OPT > 0 -> z_input = z_helio, z_out = zcmb
+  //   OPT < 0 -> z_input = z_cmb,   z_out = zhelio
+  //   ICOORDSYS = ICOORDSYS_EQ (RA,DEC = J2000) or ICOORDSYS_GAL (l,b)
+  //
+  // The CMB apex unit vector is computed once and, for equatorial
+  // input, rotated into the J2000 frame with the transpose of the 
+  // slaEqgal rotation matrix; then V0.nhat is a dot product with
+  // the object's equatorial unit vector and no per-object frame 
+  // conversion is needed. The object loop has no branches or calls
+  // other than sin/cos, so that it vectorizes.
+  // As in zhelio_zcmb_translator, z_input < 1E-10 is returned 
+  // unchanged to preserve flags such as -9.
+
+  double cosb = cos(RADIAN*CMBapex_b);
+  double VGAL[3], V[3], x, y, zz, cosd, vdotn, ZP1, ZOUT ;
+  bool   TO_CMB = ( OPT > 0 ) ;
+  int    o, i ;
+  char   fnam[] = "zhelio_zcmb_translator_array" ;
+  char c1loc[200], c2loc[200] ; // local msg for thread safety
+
+  // --------------- BEGIN ------------
+
+  if ( OPT == 0 ) {
+    sprintf(c1loc,"Invalid OPT=0" );
+    sprintf(c2loc,"NOBJ=%d  ICOORDSYS=%d", NOBJ, ICOORDSYS);
+    errmsg(SEV_FATAL, 0, fnam, c1loc, c2loc);
+  }
+
+  // CMB velocity vector in units of c, galactic frame
+  VGAL[0] = cosb * cos(RADIAN*CMBapex_l) ;
+  VGAL[1] = cosb * sin(RADIAN*CMBapex_l) ;
+  VGAL[2] = sin(RADIAN*CMBapex_b) ;
+  for(i=0; i < 3; i++ ) { VGAL[i] *= CMBapex_v / LIGHT_km ; }
+
+  galvec_to_COORDSYS(ICOORDSYS, VGAL, V);
+
+  for(o=0; o < NOBJ; o++ ) {
+    cosd  = cos(RADIAN*DEC[o]) ;
+    x     = cosd * cos(RADIAN*RA[o]) ;
+    y     = cosd * sin(RADIAN*RA[o]) ;
+    zz    = sin(RADIAN*DEC[o]) ;
+    vdotn = V[0]*x + V[1]*y + V[2]*zz ;
+    ZP1   = 1.0 + z_input[o] ;
+    ZOUT  = ( TO_CMB ) ? ZP1/(1.0-vdotn) : ZP1*(1.0-vdotn) ;
+    z_out[o] = ( z_input[o] < 1.0E-10 ) ? z_input[o] : ZOUT - 1.0 ;
+  }
+
+  return ;
+
+} // end zhelio_zcmb_translator_array
+
+
+// ************************************************
+void eval_COSMO_CATALOG(int NOBJ, double *zHEL, double *RA, double *DEC,
+			int ICOORDSYS, const HzFUN_INFO_DEF *HzFUN_INFO,
+			const ANISOTROPY_INFO_DEF *ANISOTROPY_INFO,
+			double *zCMB, double *MU, double *DVDZ) {
+
+  // Created Oct 2026
+  // Evaluate catalog of NOBJ objects with OpenMP work-splitting:
+  //   zCMB[o] = zCMB from zHEL[o] and sky position RA[o],DEC[o] in
+  //             ICOORDSYS (ICOORDSYS_EQ or ICOORDSYS_GAL). 
+  //             If RA=NULL, zCMB = zHEL.
+  //   MU[o]   = distance modulus (anisotropic if ANISOTROPY_INFO 
+  //             is not NULL and USE_FLAG is set; then each object 
+  //             uses its own direction). Skip if MU=NULL.
+  //   DVDZ[o] = dV/dz at zCMB. Skip if DVDZ=NULL.
+  //
+  // Catalog is split into chunks of NCHUNK_COSMO_CATALOG objects
+  // processed by the batch functions; HzFUN_INFO and ANISOTROPY_INFO
+  // are only read, so all threads share them. For best speed, 
+  // HzFUN_INFO should have its distance table (init_HzFUN_INFO).
+  // Without OpenMP (-fopenmp) chunks are processed serially.
+  // Oct 2026: objects with zHEL <= 0 (or zCMB <= 0) are not evaluated;
+  //   they get MU = DVDZ = VALUE_INVALID_COSMO_CATALOG.
+
+  bool USE_ANISO = false ;
+  int  NCHUNK = NCHUNK_COSMO_CATALOG ;
+  int  ichunk, Nchunk = (NOBJ + NCHUNK - 1) / NCHUNK ;
+
+  // --------------- BEGIN ------------
+
+  if ( NOBJ <= 0 ) { return ; }
+  if ( ANISOTROPY_INFO != NULL ) { USE_ANISO = ANISOTROPY_INFO->USE_FLAG; }
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic,1)
+#endif
+  for(ichunk=0; ichunk < Nchunk; ichunk++ ) {
+    int    o0 = ichunk * NCHUNK ;
+    int    N  = ( o0 + NCHUNK <= NOBJ ) ? NCHUNK : NOBJ - o0 ;
+    int    o, k, NVAL = 0, IVAL[NCHUNK_COSMO_CATALOG] ;
+    double H0 = HzFUN_INFO->COSPAR_LIST[ICOSPAR_HzFUN_H0];
+    double VAPEX[3], XYZ[3], COS_SEP[NCHUNK_COSMO_CATALOG], cosd ;
+    double zh[NCHUNK_COSMO_CATALOG], zc[NCHUNK_COSMO_CATALOG] ;
+    double mu[NCHUNK_COSMO_CATALOG] ;
+
+    if ( RA != NULL ) {
+      zhelio_zcmb_translator_array(N, &zHEL[o0], &RA[o0], &DEC[o0],
+				   ICOORDSYS, +1, &zCMB[o0]);
+    }
+    else { 
+      for(o=0; o < N; o++ ) { zCMB[o0+o] = zHEL[o0+o]; }
+    }
+
+    // pack objects with valid redshifts for the batch functions
+    for(o=o0; o < o0+N; o++ ) {
+      if ( zHEL[o] > 0.0 && zCMB[o] > 0.0 ) 
+	{ IVAL[NVAL] = o;  zh[NVAL] = zHEL[o];  zc[NVAL] = zCMB[o]; NVAL++; }
+      else {
+	if ( MU   != NULL ) { MU[o]   = VALUE_INVALID_COSMO_CATALOG ; }
+	if ( DVDZ != NULL ) { DVDZ[o] = VALUE_INVALID_COSMO_CATALOG ; }
+      }
+    }
+
+    if ( MU != NULL && USE_ANISO ) {
+      if ( RA != NULL ) {
+	get_ANISOTROPY_APEX(ANISOTROPY_INFO, XYZ);
+	galvec_to_COORDSYS(ICOORDSYS, XYZ, VAPEX);
+	for(k=0; k < NVAL; k++ ) {
+	  o    = IVAL[k] ;
+	  cosd = cos(RADIAN*DEC[o]);
+	  COS_SEP[k] = 
+	    VAPEX[0] * cosd * cos(RADIAN*RA[o]) + 
+	    VAPEX[1] * cosd * sin(RADIAN*RA[o]) + 
+	    VAPEX[2] * sin(RADIAN*DEC[o]) ;
+	}
+      }
+      else {
+	for(k=0; k < NVAL; k++ ) {
+	  COS_SEP[k] = cos_sep_dipole(ANISOTROPY_INFO->GLON, 
+				      ANISOTROPY_INFO->GLAT, ANISOTROPY_INFO);
+	}
+      }
+      dLmag_dipole_array(NVAL, zh, COS_SEP, H0, ANISOTROPY_INFO, mu);
+    }
+    else if ( MU != NULL ) {
+      dLmag_array(NVAL, zc, zh, HzFUN_INFO, NULL, mu);
+    }
+
+    for(k=0; k < NVAL; k++ ) {
+      o = IVAL[k] ;
+      if ( MU   != NULL ) { MU[o]   = mu[k] ; }
+      if ( DVDZ != NULL ) { DVDZ[o] = dVdz(zc[k], HzFUN_INFO); }
+    }
+  }
+
+  return ;
+
+} // end eval_COSMO_CATALOG
+
+
 double zhelio_zcmb_translator__ (double *z_input, double *RA, double *DEC,
                                  char *coordSys, int *OPT ) {
   return zhelio_zcmb_translator(*z_input, *RA, *DEC, coordSys, *OPT) ;
 }
 
 
+// ==================================================
+//   hot-path instrumentation (Oct 2026)
+// ==================================================
+
+// per-thread block, and list of all blocks for get_COSMO_STATS.
+// Blocks are never freed so that the list stays valid after 
+// worker threads exit. Per-thread TIME is accumulated in ticks of
+// time_COSMO_STATS (cpu time-stamp counter on x86, else ns), and
+// converted to seconds in get_COSMO_STATS using the wall clock
+// elapsed since the first block was created.
+static __thread COSMO_STATS_DEF *COSMO_STATS_THREAD = NULL ;
+static COSMO_STATS_DEF *COSMO_STATS_LIST = NULL ;
+static double TICK0_COSMO_STATS, WALL0_COSMO_STATS ;
+
+static double wall_COSMO_STATS(void) {
+  struct timespec ts ;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + 1.0E-9*(double)ts.tv_nsec ;
+} // end wall_COSMO_STATS
+
+static COSMO_STATS_DEF *thread_COSMO_STATS(void) {
+  // return block for this thread; allocate and push on list 
+  // (lock-free) on first use.
+  COSMO_STATS_DEF *S = COSMO_STATS_THREAD ;
+  if ( S != NULL ) { return S ; }
+  S = (COSMO_STATS_DEF*) calloc(1, sizeof(COSMO_STATS_DEF));
+  S->NEXT = __atomic_load_n(&COSMO_STATS_LIST, __ATOMIC_ACQUIRE);
+  while ( !__atomic_compare_exchange_n(&COSMO_STATS_LIST, &S->NEXT, S, 
+				       false, __ATOMIC_RELEASE,
+				       __ATOMIC_ACQUIRE) ) { ; }
+  if ( S->NEXT == NULL ) {   // first block -> start tick calibration
+    WALL0_COSMO_STATS = wall_COSMO_STATS();
+    TICK0_COSMO_STATS = time_COSMO_STATS();
+  }
+  COSMO_STATS_THREAD = S ;
+  return S ;
+} // end thread_COSMO_STATS
+
+double time_COSMO_STATS(void) {
+  // return time stamp in ticks; a few ns per call
+#if defined(__x86_64__) && defined(__GNUC__)
+  return (double)__rdtsc() ;
+#else
+  return 1.0E9 * wall_COSMO_STATS() ;
+#endif
+} // end time_COSMO_STATS
+
+void add_COSMO_STATS(int ISTAT, double TIME) {
+  COSMO_STATS_DEF *S = thread_COSMO_STATS();
+  S->NCALL[ISTAT]++ ;
+  S->TIME[ISTAT] += TIME ;
+} // end add_COSMO_STATS
+
+void add_COSMO_STATS_NEVAL(long NEVAL) {
+  thread_COSMO_STATS()->NEVAL_HzFUN += NEVAL ;
+} // end add_COSMO_STATS_NEVAL
+
+void add_COSMO_STATS_NITER(int NITER) {
+  if ( NITER >= MXITER_HIST_COSMO_STATS ) 
+    { NITER = MXITER_HIST_COSMO_STATS-1 ; }
+  thread_COSMO_STATS()->NITER_INVERT[NITER]++ ;
+} // end add_COSMO_STATS_NITER
+
+
+// ******************************************
+void get_COSMO_STATS(COSMO_STATS_DEF *STATS) {
+
+  // Created Oct 2026
+  // Return STATS = sum of per-thread instrumentation blocks.
+  // Counts from threads that are still running may be slightly 
+  // behind; call after parallel work is done for exact totals.
+
+  COSMO_STATS_DEF *S ;
+  double DTICK, SEC_PER_TICK = 1.0E-9 ;
+  int i ;
+
+  memset(STATS, 0, sizeof(COSMO_STATS_DEF));
+  S = __atomic_load_n(&COSMO_STATS_LIST, __ATOMIC_ACQUIRE);
+  if ( S == NULL ) { return ; }
+
+  DTICK = time_COSMO_STATS() - TICK0_COSMO_STATS ;
+  if ( DTICK > 0.0 ) 
+    { SEC_PER_TICK = (wall_COSMO_STATS() - WALL0_COSMO_STATS) / DTICK ; }
+
+  for( ; S != NULL; S = S->NEXT ) {
+    for(i=0; i < NSTAT_COSMO; i++ ) {
+      STATS->NCALL[i] += S->NCALL[i] ;
+      STATS->TIME[i]  += S->TIME[i] ;
+    }
+    for(i=0; i < MXITER_HIST_COSMO_STATS; i++ ) 
+      { STATS->NITER_INVERT[i] += S->NITER_INVERT[i] ; }
+    STATS->NEVAL_HzFUN += S->NEVAL_HzFUN ;
+  }
+  for(i=0; i < NSTAT_COSMO; i++ ) { STATS->TIME[i] *= SEC_PER_TICK ; }
+
+} // end get_COSMO_STATS
+
+
+// ******************************************
+void reset_COSMO_STATS(void) {
+  // Created Oct 2026
+  // Zero all per-thread blocks; call outside parallel regions.
+  COSMO_STATS_DEF *S, *NEXT ;
+  S = __atomic_load_n(&COSMO_STATS_LIST, __ATOMIC_ACQUIRE);
+  for( ; S != NULL; S = NEXT ) {
+    NEXT = S->NEXT ;
+    memset(S, 0, sizeof(COSMO_STATS_DEF));
+    S->NEXT = NEXT ;
+  }
+} // end reset_COSMO_STATS
+
+
+// ******************************************
+void dump_COSMO_STATS(FILE *fp) {
+
+  // Created Oct 2026
+  // Print summary of cosmology instrumentation: calls, total and 
+  // mean time per function, number of H(z) evaluations, and 
+  // histogram of zcmb_dLmag_invert iterations.
+
+  char NAME[NSTAT_COSMO][40] = {
+    "Hzfun", "Hzinv_integral", "dLmag(iso)", "dLmag(aniso)", 
+    "dLmag_array", "dVdz_integral", "SFR_integral", 
+    "zcmb_dLmag_invert", "zhelio_zcmb_translator" 
+  } ;
+  COSMO_STATS_DEF STATS ;
+  long   NINV = 0 ;
+  int    i ;
+  char fnam[] = "dump_COSMO_STATS" ;
+
+  // ------------ BEGIN ------------
+
+  fprintf(fp, "\n  %s: \n", fnam);
+
+#ifndef USE_COSMO_STATS
+  fprintf(fp, "\t Instrumentation disabled "
+	  "(compile with -DUSE_COSMO_STATS) \n");
+  fflush(fp);
+  return ;
+#endif
+
+  get_COSMO_STATS(&STATS);
+
+  fprintf(fp, "\t %-24s %12s %10s %10s \n", 
+	  "Function", "Ncall", "Time(s)", "ns/call");
+  for(i=0; i < NSTAT_COSMO; i++ ) {
+    if ( STATS.NCALL[i] == 0 ) { continue; }
+    if ( i == ISTAT_COSMO_Hzfun ) {
+      fprintf(fp, "\t %-24s %12ld %10s %10s \n", 
+	      NAME[i], STATS.NCALL[i], "-", "-" );
+      continue ;
+    }
+    fprintf(fp, "\t %-24s %12ld %10.3f %10.1f \n", 
+	    NAME[i], STATS.NCALL[i], STATS.TIME[i],
+	    1.0E9 * STATS.TIME[i] / (double)STATS.NCALL[i] );
+  }
+  fprintf(fp, "\t Total H(z) evaluations: %ld \n", STATS.NEVAL_HzFUN);
+
+  for(i=0; i < MXITER_HIST_COSMO_STATS; i++ ) 
+    { NINV += STATS.NITER_INVERT[i]; }
+  if ( NINV > 0 ) {
+    fprintf(fp, "\t zcmb_dLmag_invert iterations (0 = table lookup): \n");
+    for(i=0; i < MXITER_HIST_COSMO_STATS; i++ ) {
+      if ( STATS.NITER_INVERT[i] == 0 ) { continue; }
+      fprintf(fp, "\t    NITER %s%2d : %ld \n", 
+	      (i == MXITER_HIST_COSMO_STATS-1) ? ">=" : "  ", i, 
+	      STATS.NITER_INVERT[i] );
+    }
+  }
+  fflush(fp);
+
+} // end dump_COSMO_STATS
+
+void dump_cosmo_stats__(void) { dump_COSMO_STATS(stdout); }
+
+
 // end:
 
@@ -12,21 +12,212 @@
 #define ICOSPAR_HzFUN_wa  4
 #define NCOSPAR_HzFUN     5
 
-#define MXMAP_HzFUN 5000  
+// Oct 2026: H(z) map is resampled on uniform z grid (init_HzFUN_MAPGRID)
+// so that Hzfun_interp uses direct index computation.
+#define OPT_INTERP_HzFUN_MAP_LINEAR  1  // linear (default, as before)
+#define OPT_INTERP_HzFUN_MAP_PCHIP   2  // monotone cubic (Fritsch-Carlson)
+#define DZMAX_HzFUN_MAPGRID   0.001     // max z-binsize of uniform grid
+#define MXGRID_HzFUN_MAP      500000    // max number of grid nodes
+
+// Oct 2026: binary H(z) map (see write_HzFUN_BINARY). File is a
+// fixed-size header followed by double arrays
+//   zCMB_MAP[Nmap], HzFUN_MAP[Nmap], Hz_GRID[Ngrid], dHdz_GRID[Ngrid],
+//   and optionally DC_TABLE[Ntable], EINV_TABLE[Ntable].
+// File is mmap'd read-only, so pages are shared by all processes
+// on a node. CHECKSUM is 64-bit FNV-1a of the data arrays.
+#define MAGIC_HzFUN_BINARY       "SNHZBIN"
+#define VERSION_HzFUN_BINARY     1
+#define GRIDTYPE_HzFUN_UNIFORM_Z 1
+#define NBYTE_HEADER_HzFUN_BINARY 256
+
+typedef struct {
+  char     MAGIC[8] ;          // MAGIC_HzFUN_BINARY
+  int      VERSION ;
+  int      GRIDTYPE ;          // GRIDTYPE_HzFUN_XXX
+  int      OPT_INTERP_MAP ;    // used to compute Hz_GRID, dHdz_GRID
+  int      Nzbin_MAP, Nzbin_GRID, Nzbin_TABLE ; // Nzbin_TABLE=0 -> no table
+  double   COSPAR_LIST[NCOSPAR_HzFUN] ; // documentation; H0 for table
+  double   dz_GRID, zmax_GRID, dz_TABLE, zmax_TABLE ;
+  unsigned long long CHECKSUM ;
+} HzFUN_BINARY_HEADER_DEF ;
+
+// Oct 2026: persistent on-disk cache of distance and inverse tables,
+// enabled with set_HzFUN_TABLE_CACHE(dirName) or with environment
+// variable ENV_HzFUN_TABLE_CACHE. Each table set is one file
+//    <dirName>/HzFUN_TABLE_<KEY>.bin
+// where KEY is the 64-bit FNV-1a hash of the table key (see
+// get_HzFUN_TABLE_CACHE_KEY). File is a fixed-size header followed by
+//   DC_TABLE[Ntable], EINV_TABLE[Ntable],
+//   zCMB_MUINV[Nmuinv], dzdmu_MUINV[Nmuinv].
+// Increment VERSION_HzFUN_TABLE_CACHE when table construction changes.
+#define MAGIC_HzFUN_TABLE_CACHE        "SNHZTAB"
+#define VERSION_HzFUN_TABLE_CACHE      1
+#define NBYTE_HEADER_HzFUN_TABLE_CACHE 256
+#define ENV_HzFUN_TABLE_CACHE          "SNANA_HzFUN_TABLE_CACHE"
+
+typedef struct {
+  char     MAGIC[8] ;          // MAGIC_HzFUN_TABLE_CACHE
+  int      VERSION ;
+  int      IPREC ;
+  int      Nzbin_TABLE, Nbin_MUINV ;
+  unsigned long long KEY ;     // hash of table key; also in file name
+  double   COSPAR_KEY[NCOSPAR_HzFUN] ; // documentation
+  double   H0REF_TABLE ;
+  double   dz_TABLE, zmax_TABLE ;
+  double   mumin_MUINV, mumax_MUINV, dmu_MUINV ;
+  unsigned long long CHECKSUM ; // FNV-1a of data arrays
+} HzFUN_TABLE_CACHE_HEADER_DEF ;
+
+// Oct 2026: cumulative table of dimensionless comoving distance,
+//   DC(z) = int_0^z H0/H(z') dz'
+// built once in init_HzFUN_INFO and used by Hzinv_integral, 
+// Hainv_integral, dVdz and dLmag. Nodes are uniform in z and the
+// lookup is a cubic Hermite interpolation using the exact slope
+// H0/H(z) at each node, so interpolation error is < dz^4/384*|DC''''|;
+// for dz=0.005 this is < 1E-8 mag for any z above 0.001.
+// Redshifts beyond the table fall back to direct integration.
+// Oct 2026: for analytic H(z), DC(z) depends only on (OM,OL,w0,wa);
+// for a map, DC scales as H0. Tables are thus shared across H0 
+// (see set_HzFUN_H0, get_HzFUN_TABLE_KEY), and the distance modulus
+// shifts by exactly -5*log10(H0/H0REF).
+#define ZMAX_HzFUN_TABLE   10.0   // max zCMB covered by table
+#define DZBIN_HzFUN_TABLE  0.005  // z-binsize of table nodes
+#define NGL_HzFUN          4      // Gauss-Legendre points per bin
+
+// Oct 2026: inverse table zCMB(MU) on uniform MU grid, used by 
+// zcmb_dLmag_invert. Hermite interpolation error in z is < 1E-10.
+#define ZMIN_MUINV_TABLE   1.0E-4  // min zCMB in inverse table
+#define DMUBIN_MUINV_TABLE 0.02    // MU-binsize of inverse table
+
+// Oct 2026: closed-form LCDM distance (DC_LCDM_closed) for w0=-1,wa=0,
+// using Carlson's RF. E^2 = OM*x^3 + OK*x^2 + OL (x=1+z) is factored 
+// into (x-ROOT)*(OM*x^2 + G*x + F) with ROOT = largest real root.
+// Requires OM >= OMMIN_LCDM_CLOSED and ROOT < 1 (no bounce).
+#define OMMIN_LCDM_CLOSED   1.0E-4
+
+// Oct 2026: max sub-bin size for single-pass dVdz_integral_curve
+#define DZBIN_dVdz_CURVE    0.005
+#define NSUBMIN_dVdz_CURVE  50
+
+// Oct 2026: block size for batch H(z) evaluation in quadrature loops
+#define NBLOCK_HzFUN  64
+
+// Oct 2026: max z-bin of sorted-segment quadrature (Hzinv_nodes_sorted)
+#define DZBIN_SEGMENT_HzFUN  0.002
+
+// Oct 2026: adaptive Gauss-Kronrod integration (integrate_GK15).
+// Tolerance is given as precision on distance modulus (mag).
+#define TOLMAG_INTEG_DEFAULT  1.0E-6
+#define MXINTERVAL_GK15       200
+
+// Oct 2026: precision tier (set_HzFUN_PRECISION) used by dLmag,
+// dVdz_integral, zcmb_dLmag_invert and the other integrals.
+//   FAST      : ~1E-4 mag for simulations; coarse tables that fit in L1
+//   STANDARD  : ~1E-6 mag (default, as before)
+//   REFERENCE : ~1E-10 mag; no tables, adaptive quadrature with 
+//               tight tolerance and compensated summation.
+#define IPREC_HzFUN_FAST        1
+#define IPREC_HzFUN_STANDARD    2
+#define IPREC_HzFUN_REFERENCE   3
+#define TOLMAG_INTEG_FAST       1.0E-4
+#define TOLMAG_INTEG_REFERENCE  1.0E-10
+#define DZBIN_HzFUN_TABLE_FAST  0.05   // z-binsize of FAST distance table
+#define DMUBIN_MUINV_TABLE_FAST 0.2    // MU-binsize of FAST inverse table
+#define DMU_CONVERGE_INVERT     1.0E-4 // zcmb_dLmag_invert, FAST,STANDARD
+#define DMU_CONVERGE_MUINV      1.0E-10 // Newton tolerance, MUINV nodes
+#define MXITER_MUINV_TABLE      20      // max Newton iter per MUINV node
+
+// Oct 2026: single memory block from which the arrays of a shared
+// payload are carved (alloc_HzFUN_ARENA), sized to the actual number
+// of bins; each array starts on a 64-byte boundary of the block.
+#define NALIGN_HzFUN_ARENA  8   // alignment in doubles
+typedef struct {
+  double *BUF ;
+  size_t NDOUBLE, NUSED ;
+} HzFUN_ARENA_DEF ;
+
 //new definition  for PI
 
 #define PI 3.141592653589
-typedef struct {
+typedef struct HzFUN_INFO_DEF {
   double COSPAR_LIST[NCOSPAR_HzFUN];
+  int    IPREC ;                  // IPREC_HzFUN_XXX (Oct 2026)
+
+  // Oct 2026: lifecycle for instances from create_HzFUN_INFO; map and
+  // tables then point into reference-counted payloads that are shared
+  // with other instances (see HzFUN_SHARED_DEF). Instances from
+  // init_HzFUN_INFO have USE_SHARED=false and own their arrays.
+  bool   USE_SHARED ;
+  int    NREF ;                   // retain/release count
+  struct HzFUN_SHARED_DEF *SHARED_MAP, *SHARED_TABLE ;
   
   // optional 2-column map to define theory H(z)
   bool   USE_MAP ;
   char   *FILENAME ;
-  int    Nzbin_MAP;
+  int    Nzbin_MAP;               // dynamic size (Oct 2026)
   double *zCMB_MAP, *HzFUN_MAP ;
 
+  // map resampled on uniform z grid (Oct 2026)
+  int    OPT_INTERP_MAP ;         // OPT_INTERP_HzFUN_MAP_XXX
+  int    Nzbin_GRID ;             // number of grid nodes, incl. z=0
+  double dz_GRID, zmax_GRID ;
+  double *Hz_GRID, *dHdz_GRID ;   // H and dH/dz at each grid node
+
+  // read-only memory map for binary map file (Oct 2026); 
+  // map, grid and table arrays then point into the mapped file.
+  bool   USE_MMAP ;
+  void   *MMAP_ADDR ;
+  size_t MMAP_SIZE ;
+  bool   MMAP_TABLE ;             // DC_TABLE,EINV_TABLE from file
+
+  // optional cumulative distance table (Oct 2026)
+  bool   USE_TABLE ;
+  int    Nzbin_TABLE ;       // number of z nodes, including z=0
+  double zmax_TABLE, dz_TABLE ;
+  double *DC_TABLE ;         // int_0^z H0REF/H dz at each node
+  double *EINV_TABLE ;       // H0REF/H(z) at each node = dDC/dz
+
+  // Oct 2026: tables are in units of c/H0REF_TABLE, so that H0 enters
+  // only through SCALE_TABLE and DMU_MUINV (see set_HzFUN_H0)
+  double H0REF_TABLE ;       // H0 used to build the tables
+  double SCALE_TABLE ;       // factor for DC_TABLE: H0/H0REF for map
+  double DMU_MUINV ;         // MU shift for MUINV: 5*log10(H0/H0REF)
+
+  // closed-form LCDM distance (Oct 2026; see init_HzFUN_LCDM)
+  bool   USE_LCDM_CLOSED ;
+  double ROOT_LCDM, G_LCDM, F_LCDM ;
+
+  // inverse table, isotropic zCMB(MU) with zHEL=zCMB (Oct 2026)
+  int    Nbin_MUINV ;        // 0 -> no inverse table
+  double mumin_MUINV, mumax_MUINV, dmu_MUINV ;
+  double *zCMB_MUINV ;       // zCMB at each MU node
+  double *dzdmu_MUINV ;      // dz/dMU at each MU node (slope-limited)
+
 } HzFUN_INFO_DEF ;
 
+// Oct 2026: immutable payload shared by HzFUN_INFO instances from
+// create_HzFUN_INFO. MAP payload: map and grid arrays for a map file
+// (or the mmap of a binary map), keyed by FILENAME and OPT_INTERP_MAP,
+// plus COSPAR_LIST for a debug OUT map (see is_HzFUN_MAP_OUTFILE).
+// TABLE payload: distance and inverse tables, keyed by MAP payload,
+// COSPAR_LIST and IPREC. SRC holds the array pointers and sizes that
+// are copied into each instance.
+#define ITYPE_HzFUN_SHARED_MAP    1
+#define ITYPE_HzFUN_SHARED_TABLE  2
+
+typedef struct HzFUN_SHARED_DEF {
+  int    ITYPE ;                  // ITYPE_HzFUN_SHARED_XXX
+  int    NREF ;                   // number of instances using payload
+  char   *FILENAME ;              // MAP key
+  int    OPT_INTERP_MAP ;         // MAP key
+  struct HzFUN_SHARED_DEF *MAP ;  // TABLE key (NULL for analytic H)
+  double COSPAR_LIST[NCOSPAR_HzFUN] ; // TABLE key (and OUT-MAP key)
+  int    IPREC ;                  // TABLE key
+  HzFUN_ARENA_DEF ARENA ;         // memory for arrays (not for mmap)
+  HzFUN_INFO_DEF  SRC ;
+  struct HzFUN_SHARED_DEF *NEXT ;
+} HzFUN_SHARED_DEF ;
+
 
 // hard-wired params from 1808.04597 (Colin et al 2023)
 #define ANISOTROPY_MODEL_qm  -0.157
@@ -35,48 +226,395 @@ typedef struct {
 #define ANISOTROPY_MODEL_J0  -0.489
 #define ANISOTROPY_MODEL_S0   -999.0 // tbd
 
+// default dipole apex (galactic coords, deg); see init_ANISOTROPY_INFO
+#define ANISOTROPY_GLON_APEX  264.021
+#define ANISOTROPY_GLAT_APEX   48.253
+
 typedef struct {
   // Created Feb 2023 by A.Sha and R.Kessler
   bool   USE_FLAG ;
   double qm, qd, S, J0, S0; 
   double GLON, GLAT; 
 
+  // Oct 2026: configurable apex and precomputed geometry; call 
+  // init_ANISOTROPY_INFO, set_ANISOTROPY_APEX to change apex, and
+  // set_ANISOTROPY_DIRECTION to set GLON,GLAT with COS_SEP.
+  double GLON_APEX, GLAT_APEX ;  // dipole apex (deg)
+  double XYZ_APEX[3] ;           // unit vector to apex
+  double GLON_LAST, GLAT_LAST ;  // GLON,GLAT used for COS_SEP
+  double COS_SEP ;               // cos(angle between GLON,GLAT and apex)
+
 } ANISOTROPY_INFO_DEF ;
 
+// Oct 2026: sky scan of dipole apex (scan_ANISOTROPY_SKY); parameter
+// set iset is PARSET[iset*NPAR_ANISOTROPY_SCAN + IPAR_ANISOTROPY_SCAN_XXX]
+#define IPAR_ANISOTROPY_SCAN_qm   0
+#define IPAR_ANISOTROPY_SCAN_qd   1
+#define IPAR_ANISOTROPY_SCAN_S    2
+#define IPAR_ANISOTROPY_SCAN_J0   3
+#define NPAR_ANISOTROPY_SCAN      4
+#define CHI2_INVALID_ANISOTROPY_SCAN  1.0E30  // DL <= 0 for some object
+
+// Oct 2026: gradient of dLmag (dLmag_grad): COSPAR then anisotropy params
+#define IGRAD_dLmag_H0   ICOSPAR_HzFUN_H0
+#define IGRAD_dLmag_OM   ICOSPAR_HzFUN_OM
+#define IGRAD_dLmag_OL   ICOSPAR_HzFUN_OL
+#define IGRAD_dLmag_w0   ICOSPAR_HzFUN_w0
+#define IGRAD_dLmag_wa   ICOSPAR_HzFUN_wa
+#define IGRAD_dLmag_qm   5
+#define IGRAD_dLmag_qd   6
+#define IGRAD_dLmag_S    7
+#define IGRAD_dLmag_J0   8
+#define NGRAD_dLmag      9
+
+// Oct 2026: batch integrand, f[i] = FUN(x[i]) for i < N
+typedef void (*INTEG_FUN_DEF)(int N, double *x, void *PAR, double *f);
+
+typedef struct {
+  // Oct 2026: params passed to integrand_XXX via integrate_GK15
+  const HzFUN_INFO_DEF *HzFUN_INFO ;
+  int    OPT ;     // e.g., OPT=1 -> z-weight in dVdz_integral
+  int    SFRMODEL ;  // SFRMODEL_XXX for integrand_SFR
+  double *SFRPAR ;   // SFR model params (MD14)
+} INTEG_PAR_COSMO_DEF ;
+
+// Oct 2026: SFR models and tables (init_SFR_TABLE)
+#define SFRMODEL_BG03      1   // Baldry & Glazebrook 2003
+#define SFRMODEL_MD14      2   // Madau & Dickinson 2014 (params A,B,C,D)
+#define SFRMODEL_POWERLAW  3   // R0*(1+z)^BETA (params R0,BETA)
+#define MXPAR_SFRMODEL     4   // see NPAR_SFRMODEL for each model
+#define DZBIN_SFR_TABLE    0.005
+
+#define ISFRVAR_SFR           0  // SFR(z)
+#define ISFRVAR_SFRINT        1  // SFR_integral(z): mass formed before z
+#define ISFRVAR_RATEdVdz      2  // SFR(z) * dV/dz
+#define ISFRVAR_RATEdVdz_CUM  3  // int_0^z SFR * dV/dz dz
+
+typedef struct {
+  int    MODEL ;                     // SFRMODEL_XXX
+  double PARAMS[MXPAR_SFRMODEL] ;    // model params (MD14, POWERLAW)
+  const HzFUN_INFO_DEF *HzFUN_INFO ; // cosmology; not owned
+  int    Nzbin ;                     // number of z nodes, incl. z=0
+  double zmax, dz ;
+  double *SFR, *SFRINT, *RATEdVdz, *RATEdVdz_CUM ; // see ISFRVAR_XXX
+} SFR_TABLE_DEF ;
+
+// Oct 2026: redshift sampler (init_ZSAMPLER, draw_ZSAMPLER) for
+// dN/dz ~ RATE(z)*dV/dz/(1+z), RATE from SFRfun_MODEL.
+#define DZBIN_ZSAMPLER  0.001   // max z-binsize of tabulated pdf
+
+typedef struct {
+  int    MODEL ;                     // SFRMODEL_XXX
+  double PARAMS[MXPAR_SFRMODEL] ;
+  double zmin, zmax, dz ;
+  int    Nzbin ;
+  double NORM ;       // int RATE*dV/dz/(1+z) dz (before normalization)
+  double *PDF ;       // normalized pdf at Nzbin+1 nodes
+  double *CDF ;       // normalized CDF at nodes; CDF[Nzbin] = 1
+  int    *GUIDE ;     // guide table (Nzbin entries) -> start bin
+} ZSAMPLER_DEF ;
+
+// Oct 2026: coordinate systems for zhelio_zcmb_translator_array
+#define ICOORDSYS_EQ   1  // "eq" or "J2000" : RA,DEC
+#define ICOORDSYS_GAL  2  // "gal" : GLON,GLAT
+
+// Oct 2026: objects per work unit in eval_COSMO_CATALOG (OpenMP)
+#define NCHUNK_COSMO_CATALOG  1024
+#define VALUE_INVALID_COSMO_CATALOG  -9.0 // MU,DVDZ for zHEL <= 0
+
+// Oct 2026: hot-path instrumentation; compile with -DUSE_COSMO_STATS
+// to enable (else macros are empty and dump reports nothing).
+// Each thread accumulates into its own block (no locks on the hot 
+// path); get_COSMO_STATS sums the blocks of all threads.
+// TIME is inclusive wall time; Hzfun is counted but not timed.
+#define ISTAT_COSMO_Hzfun           0
+#define ISTAT_COSMO_Hzinv_integral  1
+#define ISTAT_COSMO_dLmag           2  // isotropic
+#define ISTAT_COSMO_dLmag_aniso     3  // anisotropic (tilted universe)
+#define ISTAT_COSMO_dLmag_array     4
+#define ISTAT_COSMO_dVdz_integral   5
+#define ISTAT_COSMO_SFR_integral    6
+#define ISTAT_COSMO_zcmb_invert     7  // zcmb_dLmag_invert
+#define ISTAT_COSMO_zhelio_zcmb     8  // zhelio_zcmb_translator
+#define NSTAT_COSMO                 9
+#define MXITER_HIST_COSMO_STATS    16  // last bin is overflow
+
+typedef struct COSMO_STATS_DEF {
+  long   NCALL[NSTAT_COSMO] ;
+  double TIME[NSTAT_COSMO] ;      // seconds (ticks in per-thread blocks)
+  long   NEVAL_HzFUN ;            // number of H(z) evaluations
+  long   NITER_INVERT[MXITER_HIST_COSMO_STATS] ; // zcmb_dLmag_invert;
+                                  // 0 iterations -> table lookup
+  struct COSMO_STATS_DEF *NEXT ;  // list of per-thread blocks
+} COSMO_STATS_DEF ;
+
+#ifdef USE_COSMO_STATS
+#define COSMO_STATS_BEGIN  double TSTART_COSMO_STATS = time_COSMO_STATS()
+#define COSMO_STATS_END(ISTAT) \
+  add_COSMO_STATS(ISTAT, time_COSMO_STATS() - TSTART_COSMO_STATS)
+#define COSMO_STATS_COUNT(ISTAT) add_COSMO_STATS(ISTAT, 0.0)
+#define COSMO_STATS_NEVAL(N)     add_COSMO_STATS_NEVAL(N)
+#define COSMO_STATS_NITER(N)     add_COSMO_STATS_NITER(N)
+#else
+#define COSMO_STATS_BEGIN
+#define COSMO_STATS_END(ISTAT)
+#define COSMO_STATS_COUNT(ISTAT)
+#define COSMO_STATS_NEVAL(N)
+#define COSMO_STATS_NITER(N)
+#endif
+
+typedef struct {
+  // Oct 2026: used to sort catalog by zCMB in dLmag_array
+  double zCMB ;
+  int    INDEX ;
+} SORT_zCMB_DEF ;
+
+// Oct 2026: LRU cache of tabulated cosmologies behind the fortran
+// wrappers (dlmag_fortc__, dlmag_array_fortc__, dvdz_integral__).
+// Key is the exact bit pattern of COSPAR_LIST; tables are built on
+// the 2nd request for the same key so that one-off calls stay cheap.
+#define MXENTRY_COSMO_CACHE   8
+#define NSEEN_BUILD_COSMO_CACHE 2   // build tables on this request
+#define DZBIN_VOL_COSMO_CACHE 0.005 // z-binsize of cached volume curve
+#define ZMIN_VOL_COSMO_CACHE  0.2   // use curve only above this z
+
+// Oct 2026: cached tables and volume curves are held in a reference-
+// counted item (get/release_COSMO_CACHE), so that the cache lock
+// is held only for lookup; evaluation runs outside the lock, and an
+// evicted item is freed only after its last user releases it.
+typedef struct {
+  int    NREF ;            // cache entry + callers using the item
+  HzFUN_INFO_DEF *HzFUN_INFO ; // from create_HzFUN_INFO (read-only)
+
+  // cumulative volume curves for dvdz_integral__ (built on first use)
+  int    Nzbin_VOL ;       // number of z nodes; 0 -> not built
+  double dz_VOL, zmax_VOL ;
+  double *V0_VOL, *V1_VOL, *DVDZ_VOL ;
+} COSMO_CACHE_ITEM_DEF ;
+
+typedef struct {
+  double COSPAR_LIST[NCOSPAR_HzFUN] ;  // key (H0=0; see set_HzFUN_H0)
+  int    NSEEN ;           // number of requests for this key
+  unsigned long LAST_USE ; // cache clock at last request (LRU)
+  COSMO_CACHE_ITEM_DEF *ITEM ; // NULL until tables are built
+} COSMO_CACHE_ENTRY_DEF ;
+
+typedef struct {
+  unsigned long CLOCK ;
+  long   NHIT, NMISS, NEVICT ;
+  COSMO_CACHE_ENTRY_DEF ENTRY[MXENTRY_COSMO_CACHE] ;
+} COSMO_CACHE_DEF ;
+
 // ========= function prototypes =========
 
+double time_COSMO_STATS(void);
+void   add_COSMO_STATS(int ISTAT, double TIME);
+void   add_COSMO_STATS_NEVAL(long NEVAL);
+void   add_COSMO_STATS_NITER(int NITER);
+void   get_COSMO_STATS(COSMO_STATS_DEF *STATS);
+void   reset_COSMO_STATS(void);
+void   dump_COSMO_STATS(FILE *fp);
+void   dump_cosmo_stats__(void);
+
 void init_HzFUN_INFO(int VBOSE, double *cosPar, char *fileName, 
 		     HzFUN_INFO_DEF *HzFUN_INFO); 
-void write_HzFUN_FILE(HzFUN_INFO_DEF *HzFUN_INFO);
+void write_HzFUN_FILE(const HzFUN_INFO_DEF *HzFUN_INFO);
+void init_HzFUN_MAPGRID(int VBOSE, HzFUN_INFO_DEF *HzFUN_INFO);
+void set_HzFUN_MAP_INTERP(int OPT_INTERP, HzFUN_INFO_DEF *HzFUN_INFO);
+bool is_HzFUN_BINARY(char *fileName);
+void read_HzFUN_BINARY(int VBOSE, char *fileName, HzFUN_INFO_DEF *HzFUN_INFO);
+void write_HzFUN_BINARY(char *fileName, bool WRITE_TABLE, 
+			const HzFUN_INFO_DEF *HzFUN_INFO);
+void convert_HzFUN_MAP(char *textFile, char *binFile, double *cosPar, 
+		       int OPT_INTERP, bool WRITE_TABLE);
+unsigned long long checksum_FNV1a(unsigned long long HASH, 
+				  const void *DATA, size_t NBYTE);
+void init_HzFUN_TABLE(int VBOSE, HzFUN_INFO_DEF *HzFUN_INFO);
+void set_HzFUN_TABLE_CACHE(char *dirName);
+unsigned long long get_HzFUN_TABLE_CACHE_KEY(const HzFUN_INFO_DEF *HzFUN_INFO);
+bool read_HzFUN_TABLE_CACHE(int VBOSE, HzFUN_INFO_DEF *HzFUN_INFO);
+void write_HzFUN_TABLE_CACHE(int VBOSE, const HzFUN_INFO_DEF *HzFUN_INFO);
+void free_HzFUN_INFO(HzFUN_INFO_DEF *HzFUN_INFO);
+void set_HzFUN_DEFAULTS(double *cosPar, HzFUN_INFO_DEF *HzFUN_INFO);
+void read_HzFUN_MAP(int VBOSE, char *fileName, HzFUN_INFO_DEF *HzFUN_INFO);
+bool is_HzFUN_MAP_OUTFILE(char *fileName);
+
+HzFUN_INFO_DEF *create_HzFUN_INFO(int VBOSE, double *cosPar, char *fileName);
+HzFUN_INFO_DEF *retain_HzFUN_INFO(HzFUN_INFO_DEF *HzFUN_INFO);
+void   release_HzFUN_INFO(HzFUN_INFO_DEF *HzFUN_INFO);
+void   get_HzFUN_SHARED_MAP(int VBOSE, char *fileName, int OPT_INTERP,
+			    HzFUN_INFO_DEF *HzFUN_INFO);
+void   get_HzFUN_SHARED_TABLE(int VBOSE, HzFUN_INFO_DEF *HzFUN_INFO);
+void   release_HzFUN_SHARED(HzFUN_SHARED_DEF *SHARED);
+void   get_HzFUN_SHARED_STATS(int *NPAYLOAD, size_t *NBYTE);
+void   init_HzFUN_ARENA(size_t NDOUBLE, HzFUN_ARENA_DEF *ARENA);
+double *alloc_HzFUN_ARENA(size_t N, HzFUN_ARENA_DEF *ARENA);
+void   free_HzFUN_ARENA(HzFUN_ARENA_DEF *ARENA);
+void   set_HzFUN_PRECISION(int VBOSE, int IPREC, HzFUN_INFO_DEF *HzFUN_INFO);
+double get_TOLMAG_HzFUN(const HzFUN_INFO_DEF *HzFUN_INFO);
+void   set_HzFUN_H0(double H0, HzFUN_INFO_DEF *HzFUN_INFO);
+void   set_HzFUN_TABLE_SCALE(HzFUN_INFO_DEF *HzFUN_INFO);
+void   get_HzFUN_TABLE_KEY(const HzFUN_INFO_DEF *HzFUN_INFO, double *KEY);
+bool   is_HzFUN_CURVED(const HzFUN_INFO_DEF *HzFUN_INFO);
 
-double SFR_integral(double z, HzFUN_INFO_DEF *HzFUN_INFO);
+COSMO_CACHE_ITEM_DEF *get_COSMO_CACHE(double *COSPAR);
+void   release_COSMO_CACHE(COSMO_CACHE_ITEM_DEF *ITEM);
+double dVdz_integral_COSMO_CACHE(int OPT, double zmax, double H0,
+				 COSMO_CACHE_ITEM_DEF *ITEM);
+void   reset_COSMO_CACHE(void);
+void   get_COSMO_CACHE_STATS(long *NHIT, long *NMISS, long *NEVICT);
+void   cosmo_cache_stats__(long *NHIT, long *NMISS, long *NEVICT);
+double DC_TABLE_interp(double z, const HzFUN_INFO_DEF *HzFUN_INFO);
+void   init_HzFUN_LCDM(HzFUN_INFO_DEF *HzFUN_INFO);
+double DC_LCDM_closed(double zmin, double zmax, 
+		      const HzFUN_INFO_DEF *HzFUN_INFO);
+double RF_carlson(double x, double y, double z);
+void   init_MUINV_TABLE(int VBOSE, HzFUN_INFO_DEF *HzFUN_INFO);
+double zcmb_MUINV_interp(double MU, const HzFUN_INFO_DEF *HzFUN_INFO);
+
+double SFR_integral(double z, const HzFUN_INFO_DEF *HzFUN_INFO);
+double SFR_integral_tol(double z, double TOLMAG,
+			const HzFUN_INFO_DEF *HzFUN_INFO,
+			int *NEVAL);
 double SFRfun_BG03(double z,  double H0 ) ;
 double SFRfun_MD14(double z,  double *params);
+double SFRfun_MODEL(double z, int MODEL, double *params, double H0);
+int    NPAR_SFRMODEL(int MODEL);
+double SFR_integral_MODEL(double z, int MODEL, double *params, 
+			  const HzFUN_INFO_DEF *HzFUN_INFO);
+void   init_SFR_TABLE(int VBOSE, int MODEL, double *params, double zmax,
+		      const HzFUN_INFO_DEF *HzFUN_INFO, SFR_TABLE_DEF *SFR_TABLE);
+double SFR_TABLE_interp(int IVAR, double z, SFR_TABLE_DEF *SFR_TABLE);
+void   free_SFR_TABLE(SFR_TABLE_DEF *SFR_TABLE);
+
+void   init_ZSAMPLER(int VBOSE, int MODEL, double *params, 
+		     double zmin, double zmax, 
+		     const HzFUN_INFO_DEF *HzFUN_INFO, ZSAMPLER_DEF *ZSAMPLER);
+double draw_ZSAMPLER(double U, const ZSAMPLER_DEF *ZSAMPLER);
+void   draw_ZSAMPLER_array(int NDRAW, double *U, 
+			   const ZSAMPLER_DEF *ZSAMPLER, double *z);
+void   free_ZSAMPLER(ZSAMPLER_DEF *ZSAMPLER);
 
-double dVdz_integral(int OPT, double zmax, HzFUN_INFO_DEF *HzFUN_INFO);
+double dVdz_integral(int OPT, double zmax, const HzFUN_INFO_DEF *HzFUN_INFO);
+double dVdz_integral_tol(int OPT, double zmax, double TOLMAG, 
+			 const HzFUN_INFO_DEF *HzFUN_INFO, int *NEVAL);
 		     
 double dvdz_integral__(int *OPT, double *zmax, double *COSPAR);
+void dVdz_integral_curve(double zmax, int NZBIN,
+			 const HzFUN_INFO_DEF *HzFUN_INFO,
+			 double *zarr, double *V0, double *V1);
+void dvdz_integral_curve__(int *NZBIN, double *zmax, double *COSPAR,
+			   double *zarr, double *V0, double *V1);
 
-double dVdz ( double z, HzFUN_INFO_DEF *HzFUN_INFO);
-double Hzinv_integral(double zmin, double zmax, HzFUN_INFO_DEF *HzFUN_INFO); 
+double dVdz ( double z, const HzFUN_INFO_DEF *HzFUN_INFO);
+double Hzinv_integral(double zmin, double zmax,
+		      const HzFUN_INFO_DEF *HzFUN_INFO); 
 
-double Hainv_integral(double amin, double amax, HzFUN_INFO_DEF *HzFUN_INFO); 
+double Hainv_integral(double amin, double amax,
+		      const HzFUN_INFO_DEF *HzFUN_INFO); 
+double Hzinv_curvature(double sum, const HzFUN_INFO_DEF *HzFUN_INFO);
+double Hzinv_curvature_deriv(double sum, const HzFUN_INFO_DEF *HzFUN_INFO);
+double Hzinv_sum(double zmin, double zmax, double TOLMAG,
+		 const HzFUN_INFO_DEF *HzFUN_INFO, int *NEVAL);
+double Hzinv_integral_tol(double zmin, double zmax, double TOLMAG,
+			  const HzFUN_INFO_DEF *HzFUN_INFO, int *NEVAL);
+double Hainv_integral_tol(double amin, double amax, double TOLMAG,
+			  const HzFUN_INFO_DEF *HzFUN_INFO, int *NEVAL);
 
-double Hzfun ( double z, HzFUN_INFO_DEF *HzFUN_INFO); 
-double Hzfun_wCDM ( double z, HzFUN_INFO_DEF *HzFUN_INFO); 
-double Hzfun_interp ( double z, HzFUN_INFO_DEF *HzFUN_INFO); 
+double integrate_GK15(INTEG_FUN_DEF FUN, void *PAR, 
+		      double xmin, double xmax, double TOLMAG, int *NEVAL);
+void integrand_Hzinv(int N, double *z, void *PAR, double *f);
+void integrand_Hainv(int N, double *a, void *PAR, double *f);
+void integrand_SFR(int N, double *a, void *PAR, double *f);
+void integrand_dVdz(int N, double *z, void *PAR, double *f);
+
+double Hzfun ( double z, const HzFUN_INFO_DEF *HzFUN_INFO); 
+double Hzfun_wCDM ( double z, const HzFUN_INFO_DEF *HzFUN_INFO); 
+double Hzfun_interp ( double z, const HzFUN_INFO_DEF *HzFUN_INFO); 
+void   Hzfun_array(int NZ, double *zCMB, const HzFUN_INFO_DEF *HzFUN_INFO, 
+		   double *Hz);
+void   Hzfun_wCDM_array(int NZ, double *zCMB, const HzFUN_INFO_DEF *HzFUN_INFO, 
+			double *Hz);
+void   Hzfun_LCDM_kernel(int NZ, double *zCMB, double H0, double OM,
+			 double KAPPA, double OL, double *Hz);
 double dLmag ( double zCMB, double zHEL, 
-	       HzFUN_INFO_DEF *HzFUN_INFO, ANISOTROPY_INFO_DEF *ANISOTROPY_INFO  ); 
+	       const HzFUN_INFO_DEF *HzFUN_INFO, 
+	       const ANISOTROPY_INFO_DEF *ANISOTROPY_INFO  ); 
 
 double dlmag_fortc__(double *zCMB, double *zHEL, double *H0,
                      double *OM, double *OL, double *w0, double *wa);
 
-double zcmb_dLmag_invert(double MU, HzFUN_INFO_DEF *HzFUN_INFO, 
-			 ANISOTROPY_INFO_DEF *ANISOTROPY_INFO); 
+void dLmag_array(int NOBJ, double *zCMB, double *zHEL, 
+		 const HzFUN_INFO_DEF *HzFUN_INFO, 
+		 const ANISOTROPY_INFO_DEF *ANISOTROPY_INFO, double *MU ) ;
+int  sort_zCMB_compare(const void *p1, const void *p2);
+int  Hzinv_nodes_sorted(int NZ, const SORT_zCMB_DEF *SORT, 
+			double **zNODE, double **wNODE, int *IEND);
+void dLmag_COSPAR_GRID(int NZ, double *zCMB, double *zHEL, 
+		       int NGRID, double *COSPAR_GRID, double *MU);
+void dlmag_array_fortc__(int *NOBJ, double *zCMB, double *zHEL, 
+			 double *H0, double *OM, double *OL, 
+			 double *w0, double *wa, double *MU);
+
+double zcmb_dLmag_invert(double MU, const HzFUN_INFO_DEF *HzFUN_INFO, 
+			 const ANISOTROPY_INFO_DEF *ANISOTROPY_INFO); 
+void zcmb_dLmag_invert_array(int NOBJ, double *MU,
+			     const HzFUN_INFO_DEF *HzFUN_INFO,
+			     const ANISOTROPY_INFO_DEF *ANISOTROPY_INFO, 
+			     double *zCMB);
+double dLmag_grad(double zCMB, double zHEL, 
+		  const HzFUN_INFO_DEF *HzFUN_INFO, 
+		  const ANISOTROPY_INFO_DEF *ANISOTROPY_INFO, double *GRAD);
+double dlmag_grad_fortc__(double *zCMB, double *zHEL, double *H0,
+			  double *OM, double *OL, double *w0, double *wa,
+			  double *GRAD);
+double Hzinv_sum_grad(double zmin, double zmax, 
+		      const HzFUN_INFO_DEF *HzFUN_INFO, double *GRAD);
+double Hzinv_integral_grad(double zmin, double zmax, 
+			   const HzFUN_INFO_DEF *HzFUN_INFO, double *GRAD);
+double dLmag_dmudz(double zCMB, const HzFUN_INFO_DEF *HzFUN_INFO, 
+		   double *DMUDZ);
+
+void   init_ANISOTROPY_INFO(ANISOTROPY_INFO_DEF *ANISOTROPY_INFO);
+void   set_ANISOTROPY_APEX(double GLON_APEX, double GLAT_APEX,
+			   ANISOTROPY_INFO_DEF *ANISOTROPY_INFO);
+void   set_ANISOTROPY_DIRECTION(double GLON, double GLAT,
+				ANISOTROPY_INFO_DEF *ANISOTROPY_INFO);
+bool   get_ANISOTROPY_APEX(const ANISOTROPY_INFO_DEF *ANISOTROPY_INFO,
+			   double *XYZ);
+double cos_sep_dipole(double GLON, double GLAT, 
+		      const ANISOTROPY_INFO_DEF *ANISOTROPY_INFO);
+void   cos_sep_dipole_array(int NOBJ, double *GLON, double *GLAT,
+			    const ANISOTROPY_INFO_DEF *ANISOTROPY_INFO, 
+			    double *COS_SEP);
+double dLmag_dipole(double zHEL, double COS_SEP, double H0,
+		    const ANISOTROPY_INFO_DEF *ANISOTROPY_INFO);
+void   dLmag_dipole_array(int NOBJ, double *zHEL, double *COS_SEP, 
+			  double H0, const ANISOTROPY_INFO_DEF *ANISOTROPY_INFO,
+			  double *MU);
+void   init_ANISOTROPY_SKYGRID(int NPIX, double *GLON_PIX, double *GLAT_PIX);
+void   scan_ANISOTROPY_SKY(int NOBJ, double *zHEL, double *GLON, double *GLAT,
+			   double *MU, double *MUERR, 
+			   int NPIX, double *GLON_PIX, double *GLAT_PIX,
+			   int NPARSET, double *PARSET, 
+			   const HzFUN_INFO_DEF *HzFUN_INFO,
+			   double *CHI2, double *LNLIKE);
+double F_dipole(double zHEL, const ANISOTROPY_INFO_DEF *ANISOTROPY_INFO);
+double angular_separation(const ANISOTROPY_INFO_DEF *ANISOTROPY_INFO);
+double q_dipole(double zHEL, const ANISOTROPY_INFO_DEF *ANISOTROPY_INFO);
 
 double zhelio_zcmb_translator(double z_input, double RA, double DECL, 
 			      char *coordSys, int OPT ) ;
 double zhelio_zcmb_translator__(double *z_input, double *RA, double *DECL, 
 				char *coordSys, int *OPT ) ;
+int    index_COORDSYS(char *coordSys);
+void   galvec_to_COORDSYS(int ICOORDSYS, const double *VGAL, double *V);
+void   eval_COSMO_CATALOG(int NOBJ, double *zHEL, double *RA, double *DEC,
+			  int ICOORDSYS, const HzFUN_INFO_DEF *HzFUN_INFO,
+			  const ANISOTROPY_INFO_DEF *ANISOTROPY_INFO,
+			  double *zCMB, double *MU, double *DVDZ);
+void   zhelio_zcmb_translator_array(int NOBJ, double *z_input, 
+				    double *RA, double *DEC, 
+				    int ICOORDSYS, int OPT, double *z_out);
 
 // ============== END OF FILE =============
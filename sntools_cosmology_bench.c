@@ -0,0 +1,719 @@
+/*********************************************************
+**********************************************************
+
+  Created Oct 2026
+
+  Benchmark and accuracy suite for sntools_cosmology.c
+
+  Usage:
+    sntools_cosmology_bench.exe [NOBJ] [jsonFile]
+
+    NOBJ     = number of objects in synthetic SN catalog (default 100000)
+    jsonFile = output file for JSON report 
+               (default sntools_cosmology_bench.json)
+
+  Build (from SNANA src, same objects as other SNANA programs):
+    gcc -O3 -o sntools_cosmology_bench.exe sntools_cosmology_bench.c \
+        sntools_cosmology.o sntools.o <other sntools objects> -lm
+
+  For each function, report
+    + throughput (evaluations per second) over the synthetic catalog
+    + latency percentiles (p50, p90, p99) of single calls
+    + max error w.r.t. long-double reference integrator
+  and PASS/FAIL for MU error < TOLMAG_BENCH (1E-5 mag). Exit status
+  is non-zero if any check fails.
+
+  Synthetic catalog: z drawn from dN/dz ~ z^2/(1+z) up to ZMAX_BENCH,
+  isotropic sky positions, deterministic random number generator.
+
+**********************************************************
+**********************************************************/
+
+#include <time.h>
+#include "sntools.h"
+#include "sntools_cosmology.h"
+
+#define ZMAX_BENCH       2.5
+#define TOLMAG_BENCH     1.0E-5   // max allowed MU error (mag)
+#define TOLREL_BENCH     1.0E-5   // max allowed relative error
+#define NLAT_BENCH       20000    // max number of single-call latencies
+#define NBIN_REF_BENCH   1000     // GL bins per unit z for reference
+
+typedef struct {
+  int    NOBJ ;
+  double *zCMB, *zHEL, *RA, *DEC, *GLON, *GLAT ;
+} CATALOG_BENCH_DEF ;
+
+typedef struct {
+  char   NAME[60] ;
+  long   NEVAL ;
+  double TIME_TOT ;          // total seconds for NEVAL evaluations
+  double LAT_P50, LAT_P90, LAT_P99 ;  // single-call latency, ns
+  double ERRMAX ;            // max error w.r.t. reference
+  char   ERRUNIT[12] ;       // "mag", "rel" or "z"
+  double TOL ;               // pass if ERRMAX < TOL (TOL<0 -> no check)
+} RESULT_BENCH_DEF ;
+
+#define MXRESULT_BENCH 20
+RESULT_BENCH_DEF RESULT_BENCH[MXRESULT_BENCH] ;
+int  NRESULT_BENCH = 0 ;
+
+CATALOG_BENCH_DEF  CATALOG ;
+HzFUN_INFO_DEF     HzFUN_INFO, HzFUN_INFO_MAP ;
+ANISOTROPY_INFO_DEF ANISOTROPY_INFO ;
+double COSPAR_BENCH[NCOSPAR_HzFUN] = { 70.0, 0.315, 0.685, -0.9, 0.1 } ;
+
+// function prototypes
+void   gen_CATALOG_BENCH(int NOBJ, unsigned long long SEED);
+double ran_BENCH(unsigned long long *STATE);
+double time_now_BENCH(void);
+int    compare_double_BENCH(const void *a, const void *b);
+RESULT_BENCH_DEF *new_RESULT_BENCH(char *NAME, char *ERRUNIT, double TOL);
+void   set_latency_BENCH(RESULT_BENCH_DEF *R, int NLAT, double *LAT);
+void   write_json_BENCH(FILE *fp);
+
+long double Hzfun_ref(long double z);
+long double DC_ref(long double zmin, long double zmax);
+long double dLmag_ref(long double zCMB, long double zHEL);
+long double dLmag_aniso_ref(long double zHEL, long double GLON,
+			    long double GLAT);
+long double dVdz_integral_ref(int OPT, long double zmax);
+long double SFR_integral_ref(long double z);
+long double zcmb_ref(long double zHEL, long double RA, long double DEC);
+
+void bench_Hzfun(void);
+void bench_Hzinv_integral(void);
+void bench_Hainv_integral(void);
+void bench_dVdz_integral(void);
+void bench_SFR_integral(void);
+void bench_dLmag(void);
+void bench_dLmag_aniso(void);
+void bench_dLmag_array(void);
+void bench_zcmb_dLmag_invert(void);
+void bench_zhelio_zcmb_translator(void);
+
+// ============================================
+int main(int argc, char **argv) {
+
+  int  NOBJ = 100000, ires, NFAIL = 0 ;
+  char *jsonFile = "sntools_cosmology_bench.json" ;
+  char mapFile[] = "sntools_cosmology_bench_HzMAP_OUT.txt" ;
+  FILE *fp ;
+
+  // ----------- BEGIN ------------
+
+  if ( argc > 1 ) { sscanf(argv[1], "%d", &NOBJ); }
+  if ( argc > 2 ) { jsonFile = argv[2]; }
+
+  gen_CATALOG_BENCH(NOBJ, 12345ULL);
+
+  init_HzFUN_INFO(0, COSPAR_BENCH, "NONE", &HzFUN_INFO);
+  init_HzFUN_INFO(0, COSPAR_BENCH, mapFile, &HzFUN_INFO_MAP);
+  remove(mapFile);
+
+  init_ANISOTROPY_INFO(&ANISOTROPY_INFO);
+  ANISOTROPY_INFO.USE_FLAG = true ;
+
+  bench_Hzfun();
+  bench_Hzinv_integral();
+  bench_Hainv_integral();
+  bench_dVdz_integral();
+  bench_SFR_integral();
+  bench_dLmag();
+  bench_dLmag_aniso();
+  bench_dLmag_array();
+  bench_zcmb_dLmag_invert();
+  bench_zhelio_zcmb_translator();
+
+  fp = fopen(jsonFile, "wt");
+  if ( !fp ) { printf("ERROR: cannot open %s\n", jsonFile);  exit(1); }
+  write_json_BENCH(fp);
+  fclose(fp);
+  write_json_BENCH(stdout);
+
+  for(ires=0; ires < NRESULT_BENCH; ires++ ) {
+    RESULT_BENCH_DEF *R = &RESULT_BENCH[ires];
+    if ( R->TOL > 0.0 && !(R->ERRMAX < R->TOL) ) { NFAIL++ ; }
+  }
+  return ( NFAIL > 0 ) ? 1 : 0 ;
+
+} // end main
+
+
+// ============================================
+double ran_BENCH(unsigned long long *STATE) {
+  // xorshift64* ; returns uniform deviate in (0,1)
+  unsigned long long x = *STATE ;
+  x ^= x >> 12;  x ^= x << 25;  x ^= x >> 27;
+  *STATE = x ;
+  return ( (double)((x * 2685821657736338717ULL) >> 11) + 0.5 )
+    / 9007199254740992.0 ;
+} // end ran_BENCH
+
+
+void gen_CATALOG_BENCH(int NOBJ, unsigned long long SEED) {
+
+  // Generate synthetic SN catalog with NOBJ objects:
+  // z from dN/dz ~ z^2/(1+z) by rejection, isotropic sky,
+  // and peculiar-velocity-sized offset between zHEL and zCMB.
+
+  unsigned long long STATE = SEED ;
+  int    o, MEMD = NOBJ * sizeof(double) ;
+  double z, fmax, u, ra, dec ;
+
+  CATALOG.NOBJ = NOBJ ;
+  CATALOG.zCMB = (double*) malloc(MEMD);
+  CATALOG.zHEL = (double*) malloc(MEMD);
+  CATALOG.RA   = (double*) malloc(MEMD);
+  CATALOG.DEC  = (double*) malloc(MEMD);
+  CATALOG.GLON = (double*) malloc(MEMD);
+  CATALOG.GLAT = (double*) malloc(MEMD);
+
+  fmax = ZMAX_BENCH*ZMAX_BENCH / (1.0 + ZMAX_BENCH) ;
+  for(o=0; o < NOBJ; o++ ) {
+    do {
+      z = 0.005 + (ZMAX_BENCH-0.005) * ran_BENCH(&STATE) ;
+      u = fmax * ran_BENCH(&STATE) ;
+    } while ( u > z*z/(1.0+z) ) ;
+
+    ra  = 360.0 * ran_BENCH(&STATE) ;
+    dec = asin( 2.0*ran_BENCH(&STATE) - 1.0 ) / RADIAN ;
+
+    CATALOG.zCMB[o] = z ;
+    CATALOG.zHEL[o] = z + 0.001*(2.0*ran_BENCH(&STATE) - 1.0)*(1.0+z) ;
+    CATALOG.RA[o]   = ra ;
+    CATALOG.DEC[o]  = dec ;
+    slaEqgal(ra, dec, &CATALOG.GLON[o], &CATALOG.GLAT[o]);
+  }
+
+} // end gen_CATALOG_BENCH
+
+
+double time_now_BENCH(void) {
+  struct timespec ts ;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + 1.0E-9*(double)ts.tv_nsec ;
+} // end time_now_BENCH
+
+int compare_double_BENCH(const void *a, const void *b) {
+  double x = *(const double*)a, y = *(const double*)b ;
+  return (x > y) - (x < y) ;
+}
+
+RESULT_BENCH_DEF *new_RESULT_BENCH(char *NAME, char *ERRUNIT, double TOL) {
+  RESULT_BENCH_DEF *R = &RESULT_BENCH[NRESULT_BENCH++] ;
+  sprintf(R->NAME,    "%s", NAME);
+  sprintf(R->ERRUNIT, "%s", ERRUNIT);
+  R->TOL    = TOL ;
+  R->ERRMAX = 0.0 ;
+  R->NEVAL  = 0 ;
+  R->TIME_TOT = R->LAT_P50 = R->LAT_P90 = R->LAT_P99 = 0.0 ;
+  return R ;
+} // end new_RESULT_BENCH
+
+void set_latency_BENCH(RESULT_BENCH_DEF *R, int NLAT, double *LAT) {
+  // LAT = single-call times in seconds; store percentiles in ns
+  if ( NLAT <= 0 ) { return ; }
+  qsort(LAT, NLAT, sizeof(double), compare_double_BENCH);
+  R->LAT_P50 = 1.0E9 * LAT[ (int)(0.50*(NLAT-1)) ] ;
+  R->LAT_P90 = 1.0E9 * LAT[ (int)(0.90*(NLAT-1)) ] ;
+  R->LAT_P99 = 1.0E9 * LAT[ (int)(0.99*(NLAT-1)) ] ;
+} // end set_latency_BENCH
+
+
+// ============================================
+//   long double reference
+// ============================================
+
+long double Hzfun_ref(long double z) {
+  long double H0 = COSPAR_BENCH[ICOSPAR_HzFUN_H0] ;
+  long double OM = COSPAR_BENCH[ICOSPAR_HzFUN_OM] ;
+  long double OL = COSPAR_BENCH[ICOSPAR_HzFUN_OL] ;
+  long double w0 = COSPAR_BENCH[ICOSPAR_HzFUN_w0] ;
+  long double wa = COSPAR_BENCH[ICOSPAR_HzFUN_wa] ;
+  long double ZZ = 1.0L + z, K = 1.0L - OM - OL ;
+  long double ZL = powl(ZZ, 3.0L*(1.0L+w0+wa)) * expl(-3.0L*wa*z/ZZ) ;
+  return H0 * sqrtl( OM*ZZ*ZZ*ZZ + K*ZZ*ZZ + OL*ZL ) ;
+} // end Hzfun_ref
+
+long double DC_ref(long double zmin, long double zmax) {
+  // int H0/H dz with 4-point Gauss-Legendre in fine bins
+  long double H0 = COSPAR_BENCH[ICOSPAR_HzFUN_H0] ;
+  long double x[4] = { -0.861136311594052575224L, -0.339981043584856264803L,
+		        0.339981043584856264803L,  0.861136311594052575224L };
+  long double w[4] = {  0.347854845137453857373L,  0.652145154862546142627L,
+		        0.652145154862546142627L,  0.347854845137453857373L };
+  long double dz, zmid, sum = 0.0L ;
+  int  Nbin, ibin, i ;
+  if ( zmax <= zmin ) { return 0.0L ; }
+  Nbin = 1 + (int)( (zmax-zmin) * NBIN_REF_BENCH ) ;
+  dz   = (zmax-zmin) / Nbin ;
+  for(ibin=0; ibin < Nbin; ibin++ ) {
+    zmid = zmin + dz*(ibin + 0.5L) ;
+    for(i=0; i < 4; i++ )
+      { sum += 0.5L*dz*w[i] * H0 / Hzfun_ref(zmid + 0.5L*dz*x[i]); }
+  }
+  return sum ;
+} // end DC_ref
+
+static long double rcurv_ref(long double DC) {
+  // transverse comoving distance (Mpc) from dimensionless DC
+  long double OM = COSPAR_BENCH[ICOSPAR_HzFUN_OM] ;
+  long double OL = COSPAR_BENCH[ICOSPAR_HzFUN_OL] ;
+  long double K  = 1.0L - OM - OL, s = sqrtl(fabsl(K)), S ;
+  if      ( K < -1.0E-5L ) { S = sinl(s*DC)/s ; }
+  else if ( K >  1.0E-5L ) { S = sinhl(s*DC)/s ; }
+  else                     { S = DC ; }
+  return S * LIGHT_km / COSPAR_BENCH[ICOSPAR_HzFUN_H0] ;
+}
+
+long double dLmag_ref(long double zCMB, long double zHEL) {
+  long double r = rcurv_ref( DC_ref(0.0L, zCMB) ) ;
+  return 5.0L * log10l( (1.0L + zHEL) * r ) + 25.0L ;
+} // end dLmag_ref
+
+long double dLmag_aniso_ref(long double zHEL, long double GLON,
+			    long double GLAT) {
+  // tilted-universe model with exact angular separation
+  long double D2R = 3.14159265358979323846L / 180.0L ;
+  long double l1 = GLON*D2R, b1 = GLAT*D2R ;
+  long double l2 = ANISOTROPY_INFO.GLON_APEX*D2R ;
+  long double b2 = ANISOTROPY_INFO.GLAT_APEX*D2R ;
+  long double c  = sinl(b1)*sinl(b2) + cosl(b1)*cosl(b2)*cosl(l1-l2) ;
+  long double z  = zHEL, H0 = COSPAR_BENCH[ICOSPAR_HzFUN_H0] ;
+  long double q  = ANISOTROPY_INFO.qm +
+    ANISOTROPY_INFO.qd * expl(-z/ANISOTROPY_INFO.S) * c ;
+  long double dl = (LIGHT_km*z/H0) *
+    ( 1.0L + 0.5L*(1.0L-q)*z -
+      (1.0L - q - 3.0L*q*q + ANISOTROPY_INFO.J0)*z*z/6.0L ) ;
+  return 5.0L * log10l(dl) + 25.0L ;
+} // end dLmag_aniso_ref
+
+long double dVdz_integral_ref(int OPT, long double zmax) {
+  // Simpson on fine grid, carrying DC forward
+  int  N = 2 * (1 + (int)(zmax * NBIN_REF_BENCH/4)), i ;
+  long double h = zmax / N, z, DC = 0.0L, r, f, sum = 0.0L, wgt ;
+  for(i=0; i <= N; i++ ) {
+    z   = h * i ;
+    if ( i > 0 ) { DC += DC_ref(z-h, z); }
+    r   = rcurv_ref(DC) ;
+    f   = LIGHT_km * r * r / Hzfun_ref(z) ;
+    if ( OPT == 1 ) { f *= z; }
+    wgt = ( i == 0 || i == N ) ? 1.0L : ( (i%2) ? 4.0L : 2.0L ) ;
+    sum += wgt * f ;
+  }
+  return sum * h / 3.0L ;
+} // end dVdz_integral_ref
+
+long double SFR_integral_ref(long double z) {
+  // int_0^{1/(1+z)} SFR(a) / (a*H(a)) da, SFR in Msolar/yr/Mpc^3
+  long double SECONDS_PER_YEAR = 3600.0L * 24.0L * 365.0L ;
+  long double H0 = COSPAR_BENCH[ICOSPAR_HzFUN_H0] ;
+  long double amax = 1.0L/(1.0L+z), da, a, zz, sum = 0.0L, wgt ;
+  int  N = 200000, i ;
+  da = amax / N ;
+  for(i=1; i <= N; i++ ) {     // integrand -> 0 at a=0
+    a   = da * i ;  zz = 1.0L/a - 1.0L ;
+    wgt = ( i == N ) ? 1.0L : ( (i%2) ? 4.0L : 2.0L ) ;
+    sum += wgt * SFRfun_BG03((double)zz,(double)H0) / (a*Hzfun_ref(zz)) ;
+  }
+  return sum * da/3.0L * (1.0E6L * PC_km) / SECONDS_PER_YEAR ;
+} // end SFR_integral_ref
+
+long double zcmb_ref(long double zHEL, long double RA, long double DEC) {
+  // exact formula with galactic coords from slaEqgal
+  double l, b ;
+  long double vdotn ;
+  slaEqgal((double)RA, (double)DEC, &l, &b);
+  vdotn = CMBapex_v / LIGHT_km *
+    ( sinl(RADIAN*b)*sinl(RADIAN*CMBapex_b) +
+      cosl(RADIAN*b)*cosl(RADIAN*CMBapex_b)*cosl(RADIAN*(l-CMBapex_l)) );
+  return ( 1.0L + zHEL ) / ( 1.0L - vdotn ) - 1.0L ;
+} // end zcmb_ref
+
+
+// ============================================
+//   benchmarks
+// ============================================
+
+void bench_Hzfun(void) {
+
+  RESULT_BENCH_DEF *R1 = new_RESULT_BENCH("Hzfun_wCDM",   "rel", TOLREL_BENCH);
+  RESULT_BENCH_DEF *R2 = new_RESULT_BENCH("Hzfun_interp", "rel", 1.0E-3);
+  int    N = CATALOG.NOBJ, NLAT = (N < NLAT_BENCH) ? N : NLAT_BENCH, o ;
+  double *LAT = (double*) malloc(NLAT*sizeof(double));
+  double t0, t1, H, err, sum = 0.0, zmaxMap = HzFUN_INFO_MAP.zmax_GRID ;
+
+  t0 = time_now_BENCH();
+  for(o=0; o < N; o++ ) { sum += Hzfun_wCDM(CATALOG.zCMB[o], &HzFUN_INFO); }
+  R1->TIME_TOT = time_now_BENCH() - t0 ;  R1->NEVAL = N ;
+  for(o=0; o < NLAT; o++ ) {
+    t0 = time_now_BENCH();
+    H  = Hzfun_wCDM(CATALOG.zCMB[o], &HzFUN_INFO);
+    t1 = time_now_BENCH();
+    LAT[o] = t1 - t0 ;
+    err = fabs( H / (double)Hzfun_ref(CATALOG.zCMB[o]) - 1.0 );
+    if ( err > R1->ERRMAX ) { R1->ERRMAX = err; }
+  }
+  set_latency_BENCH(R1, NLAT, LAT);
+
+  t0 = time_now_BENCH();
+  for(o=0; o < N; o++ ) {
+    if ( CATALOG.zCMB[o] < zmaxMap )
+      { sum += Hzfun_interp(CATALOG.zCMB[o], &HzFUN_INFO_MAP); }
+  }
+  R2->TIME_TOT = time_now_BENCH() - t0 ;  R2->NEVAL = N ;
+  for(o=0; o < NLAT; o++ ) {
+    if ( CATALOG.zCMB[o] >= zmaxMap ) { LAT[o] = 0.0; continue; }
+    t0 = time_now_BENCH();
+    H  = Hzfun_interp(CATALOG.zCMB[o], &HzFUN_INFO_MAP);
+    t1 = time_now_BENCH();
+    LAT[o] = t1 - t0 ;
+    err = fabs( H / (double)Hzfun_ref(CATALOG.zCMB[o]) - 1.0 );
+    if ( err > R2->ERRMAX ) { R2->ERRMAX = err; }
+  }
+  set_latency_BENCH(R2, NLAT, LAT);
+
+  if ( sum < 0.0 ) { printf("%f\n", sum); } // keep loops
+  free(LAT);
+
+} // end bench_Hzfun
+
+
+void bench_Hzinv_integral(void) {
+
+  RESULT_BENCH_DEF *R = new_RESULT_BENCH("Hzinv_integral", "mag",
+					 TOLMAG_BENCH);
+  int    N = CATALOG.NOBJ, NLAT = (N < NLAT_BENCH) ? N : NLAT_BENCH, o ;
+  int    NREF = 500 ;
+  double *LAT = (double*) malloc(NLAT*sizeof(double));
+  double t0, t1, r, rref, err, sum = 0.0 ;
+
+  t0 = time_now_BENCH();
+  for(o=0; o < N; o++ )
+    { sum += Hzinv_integral(0.0, CATALOG.zCMB[o], &HzFUN_INFO); }
+  R->TIME_TOT = time_now_BENCH() - t0 ;  R->NEVAL = N ;
+
+  for(o=0; o < NLAT; o++ ) {
+    t0 = time_now_BENCH();
+    r  = Hzinv_integral(0.0, CATALOG.zCMB[o], &HzFUN_INFO);
+    t1 = time_now_BENCH();
+    LAT[o] = t1 - t0 ;
+    if ( o < NREF ) {
+      rref = (double)rcurv_ref( DC_ref(0.0L, CATALOG.zCMB[o]) );
+      err  = fabs( 5.0*log10(r/rref) ) ;
+      if ( err > R->ERRMAX ) { R->ERRMAX = err; }
+    }
+  }
+  set_latency_BENCH(R, NLAT, LAT);
+  if ( sum < 0.0 ) { printf("%f\n", sum); }
+  free(LAT);
+
+} // end bench_Hzinv_integral
+
+
+void bench_Hainv_integral(void) {
+
+  RESULT_BENCH_DEF *R = new_RESULT_BENCH("Hainv_integral", "mag",
+					 TOLMAG_BENCH);
+  int    N = CATALOG.NOBJ, NLAT = (N < NLAT_BENCH) ? N : NLAT_BENCH, o ;
+  int    NREF = 500 ;
+  double *LAT = (double*) malloc(NLAT*sizeof(double));
+  double t0, t1, a, r, rref, err, sum = 0.0 ;
+
+  t0 = time_now_BENCH();
+  for(o=0; o < N; o++ ) {
+    a    = 1.0 / (1.0 + CATALOG.zCMB[o]) ;
+    sum += Hainv_integral(a, 1.0, &HzFUN_INFO);
+  }
+  R->TIME_TOT = time_now_BENCH() - t0 ;  R->NEVAL = N ;
+
+  for(o=0; o < NLAT; o++ ) {
+    a  = 1.0 / (1.0 + CATALOG.zCMB[o]) ;
+    t0 = time_now_BENCH();
+    r  = Hainv_integral(a, 1.0, &HzFUN_INFO);
+    t1 = time_now_BENCH();
+    LAT[o] = t1 - t0 ;
+    if ( o < NREF ) {
+      rref = (double)rcurv_ref( DC_ref(0.0L, CATALOG.zCMB[o]) );
+      err  = fabs( 5.0*log10(r/rref) ) ;
+      if ( err > R->ERRMAX ) { R->ERRMAX = err; }
+    }
+  }
+  set_latency_BENCH(R, NLAT, LAT);
+  if ( sum < 0.0 ) { printf("%f\n", sum); }
+  free(LAT);
+
+} // end bench_Hainv_integral
+
+
+void bench_dVdz_integral(void) {
+
+  // volume integrals are slow for the reference, so use a fixed
+  // set of zmax values rather than the full catalog
+  RESULT_BENCH_DEF *R = new_RESULT_BENCH("dVdz_integral", "rel",
+					 TOLREL_BENCH);
+  int    NZ = 40, NREP = 50, iz, irep, opt, NLAT = 0 ;
+  double *LAT = (double*) malloc(2*NZ*NREP*sizeof(double));
+  double t0, t1, zmax, V, Vref, err, tsum = 0.0 ;
+
+  for(opt=0; opt < 2; opt++ ) {
+    for(iz=0; iz < NZ; iz++ ) {
+      zmax = 0.05 + (ZMAX_BENCH-0.05) * (double)iz / (double)(NZ-1) ;
+      for(irep=0; irep < NREP; irep++ ) {
+	t0 = time_now_BENCH();
+	V  = dVdz_integral(opt, zmax, &HzFUN_INFO);
+	t1 = time_now_BENCH();
+	LAT[NLAT++] = t1 - t0 ;  tsum += t1 - t0 ;
+      }
+      Vref = (double)dVdz_integral_ref(opt, zmax);
+      err  = fabs( V/Vref - 1.0 );
+      if ( err > R->ERRMAX ) { R->ERRMAX = err; }
+    }
+  }
+  R->TIME_TOT = tsum ;  R->NEVAL = NLAT ;
+  set_latency_BENCH(R, NLAT, LAT);
+  free(LAT);
+
+} // end bench_dVdz_integral
+
+
+void bench_SFR_integral(void) {
+
+  RESULT_BENCH_DEF *R = new_RESULT_BENCH("SFR_integral", "rel",
+					 TOLREL_BENCH);
+  int    NZ = 20, NREP = 100, iz, irep, NLAT = 0 ;
+  double *LAT = (double*) malloc(NZ*NREP*sizeof(double));
+  double t0, t1, z, S, Sref, err, tsum = 0.0 ;
+
+  for(iz=0; iz < NZ; iz++ ) {
+    z = ZMAX_BENCH * (double)iz / (double)(NZ-1) ;
+    for(irep=0; irep < NREP; irep++ ) {
+      t0 = time_now_BENCH();
+      S  = SFR_integral(z, &HzFUN_INFO);
+      t1 = time_now_BENCH();
+      LAT[NLAT++] = t1 - t0 ;  tsum += t1 - t0 ;
+    }
+    Sref = (double)SFR_integral_ref(z);
+    err  = fabs( S/Sref - 1.0 );
+    if ( err > R->ERRMAX ) { R->ERRMAX = err; }
+  }
+  R->TIME_TOT = tsum ;  R->NEVAL = NLAT ;
+  set_latency_BENCH(R, NLAT, LAT);
+  free(LAT);
+
+} // end bench_SFR_integral
+
+
+void bench_dLmag(void) {
+
+  RESULT_BENCH_DEF *R = new_RESULT_BENCH("dLmag", "mag", TOLMAG_BENCH);
+  ANISOTROPY_INFO_DEF ISO ;
+  int    N = CATALOG.NOBJ, NLAT = (N < NLAT_BENCH) ? N : NLAT_BENCH, o ;
+  int    NREF = 500 ;
+  double *LAT = (double*) malloc(NLAT*sizeof(double));
+  double t0, t1, mu, err, sum = 0.0 ;
+
+  init_ANISOTROPY_INFO(&ISO);   // USE_FLAG = false
+
+  t0 = time_now_BENCH();
+  for(o=0; o < N; o++ )
+    { sum += dLmag(CATALOG.zCMB[o], CATALOG.zHEL[o], &HzFUN_INFO, &ISO); }
+  R->TIME_TOT = time_now_BENCH() - t0 ;  R->NEVAL = N ;
+
+  for(o=0; o < NLAT; o++ ) {
+    t0 = time_now_BENCH();
+    mu = dLmag(CATALOG.zCMB[o], CATALOG.zHEL[o], &HzFUN_INFO, &ISO);
+    t1 = time_now_BENCH();
+    LAT[o] = t1 - t0 ;
+    if ( o < NREF ) {
+      err = fabs( mu - (double)dLmag_ref(CATALOG.zCMB[o],CATALOG.zHEL[o]) );
+      if ( err > R->ERRMAX ) { R->ERRMAX = err; }
+    }
+  }
+  set_latency_BENCH(R, NLAT, LAT);
+  if ( sum < 0.0 ) { printf("%f\n", sum); }
+  free(LAT);
+
+} // end bench_dLmag
+
+
+void bench_dLmag_aniso(void) {
+
+  RESULT_BENCH_DEF *R = new_RESULT_BENCH("dLmag_aniso", "mag", TOLMAG_BENCH);
+  int    N = CATALOG.NOBJ, NLAT = (N < NLAT_BENCH) ? N : NLAT_BENCH, o ;
+  double *LAT = (double*) malloc(NLAT*sizeof(double));
+  double t0, t1, mu, err, sum = 0.0 ;
+
+  t0 = time_now_BENCH();
+  for(o=0; o < N; o++ ) {
+    ANISOTROPY_INFO.GLON = CATALOG.GLON[o] ;
+    ANISOTROPY_INFO.GLAT = CATALOG.GLAT[o] ;
+    sum += dLmag(CATALOG.zCMB[o], CATALOG.zHEL[o],
+		 &HzFUN_INFO, &ANISOTROPY_INFO);
+  }
+  R->TIME_TOT = time_now_BENCH() - t0 ;  R->NEVAL = N ;
+
+  for(o=0; o < NLAT; o++ ) {
+    ANISOTROPY_INFO.GLON = CATALOG.GLON[o] ;
+    ANISOTROPY_INFO.GLAT = CATALOG.GLAT[o] ;
+    t0 = time_now_BENCH();
+    mu = dLmag(CATALOG.zCMB[o], CATALOG.zHEL[o],
+	       &HzFUN_INFO, &ANISOTROPY_INFO);
+    t1 = time_now_BENCH();
+    LAT[o] = t1 - t0 ;
+    err = fabs( mu - (double)dLmag_aniso_ref(CATALOG.zHEL[o],
+					     CATALOG.GLON[o],
+					     CATALOG.GLAT[o]) );
+    if ( err > R->ERRMAX ) { R->ERRMAX = err; }
+  }
+  set_latency_BENCH(R, NLAT, LAT);
+  if ( sum < 0.0 ) { printf("%f\n", sum); }
+  free(LAT);
+
+} // end bench_dLmag_aniso
+
+
+void bench_dLmag_array(void) {
+
+  // batch API over full catalog; no single-call latency
+  RESULT_BENCH_DEF *R = new_RESULT_BENCH("dLmag_array", "mag", TOLMAG_BENCH);
+  int    N = CATALOG.NOBJ, NREF = 500, o ;
+  double *MU = (double*) malloc(N*sizeof(double));
+  double t0, err ;
+
+  t0 = time_now_BENCH();
+  dLmag_array(N, CATALOG.zCMB, CATALOG.zHEL, &HzFUN_INFO, NULL, MU);
+  R->TIME_TOT = time_now_BENCH() - t0 ;  R->NEVAL = N ;
+
+  for(o=0; o < N && o < NREF; o++ ) {
+    err = fabs( MU[o] - (double)dLmag_ref(CATALOG.zCMB[o],CATALOG.zHEL[o]) );
+    if ( err > R->ERRMAX ) { R->ERRMAX = err; }
+  }
+  free(MU);
+
+} // end bench_dLmag_array
+
+
+void bench_zcmb_dLmag_invert(void) {
+
+  // error is |z_invert - z_true| converted to mag via dMU/dz
+  RESULT_BENCH_DEF *R = new_RESULT_BENCH("zcmb_dLmag_invert", "mag",
+					 TOLMAG_BENCH);
+  int    N = CATALOG.NOBJ, NLAT = (N < NLAT_BENCH) ? N : NLAT_BENCH, o ;
+  int    NREF = 500 ;
+  double *LAT = (double*) malloc(NLAT*sizeof(double));
+  double *MU  = (double*) malloc(NLAT*sizeof(double));
+  double t0, t1, z, ztrue, dmudz, err, sum = 0.0 ;
+
+  for(o=0; o < NLAT; o++ ) {
+    ztrue = CATALOG.zCMB[o] ;
+    MU[o] = (o < NREF) ? (double)dLmag_ref(ztrue,ztrue) :
+      dLmag_dmudz(ztrue, &HzFUN_INFO, &dmudz);
+  }
+
+  t0 = time_now_BENCH();
+  for(o=0; o < NLAT; o++ )
+    { sum += zcmb_dLmag_invert(MU[o], &HzFUN_INFO, NULL); }
+  R->TIME_TOT = time_now_BENCH() - t0 ;  R->NEVAL = NLAT ;
+
+  for(o=0; o < NLAT; o++ ) {
+    t0 = time_now_BENCH();
+    z  = zcmb_dLmag_invert(MU[o], &HzFUN_INFO, NULL);
+    t1 = time_now_BENCH();
+    LAT[o] = t1 - t0 ;
+    if ( o < NREF ) {
+      ztrue = CATALOG.zCMB[o] ;
+      dLmag_dmudz(ztrue, &HzFUN_INFO, &dmudz);
+      err = fabs( (z - ztrue) * dmudz );
+      if ( err > R->ERRMAX ) { R->ERRMAX = err; }
+    }
+  }
+  set_latency_BENCH(R, NLAT, LAT);
+  if ( sum < 0.0 ) { printf("%f\n", sum); }
+  free(LAT);  free(MU);
+
+} // end bench_zcmb_dLmag_invert
+
+
+void bench_zhelio_zcmb_translator(void) {
+
+  RESULT_BENCH_DEF *R1 =
+    new_RESULT_BENCH("zhelio_zcmb_translator", "z", 1.0E-9);
+  RESULT_BENCH_DEF *R2 =
+    new_RESULT_BENCH("zhelio_zcmb_translator_array", "z", 1.0E-9);
+  int    N = CATALOG.NOBJ, NLAT = (N < NLAT_BENCH) ? N : NLAT_BENCH, o ;
+  double *LAT  = (double*) malloc(NLAT*sizeof(double));
+  double *zOUT = (double*) malloc(N*sizeof(double));
+  double t0, t1, z, err, sum = 0.0 ;
+
+  t0 = time_now_BENCH();
+  for(o=0; o < N; o++ ) {
+    sum += zhelio_zcmb_translator(CATALOG.zHEL[o], CATALOG.RA[o],
+				  CATALOG.DEC[o], "eq", +1);
+  }
+  R1->TIME_TOT = time_now_BENCH() - t0 ;  R1->NEVAL = N ;
+
+  for(o=0; o < NLAT; o++ ) {
+    t0 = time_now_BENCH();
+    z  = zhelio_zcmb_translator(CATALOG.zHEL[o], CATALOG.RA[o],
+				CATALOG.DEC[o], "eq", +1);
+    t1 = time_now_BENCH();
+    LAT[o] = t1 - t0 ;
+    err = fabs( z - (double)zcmb_ref(CATALOG.zHEL[o], CATALOG.RA[o],
+				     CATALOG.DEC[o]) );
+    if ( err > R1->ERRMAX ) { R1->ERRMAX = err; }
+  }
+  set_latency_BENCH(R1, NLAT, LAT);
+
+  t0 = time_now_BENCH();
+  zhelio_zcmb_translator_array(N, CATALOG.zHEL, CATALOG.RA, CATALOG.DEC,
+			       ICOORDSYS_EQ, +1, zOUT);
+  R2->TIME_TOT = time_now_BENCH() - t0 ;  R2->NEVAL = N ;
+  for(o=0; o < NLAT; o++ ) {
+    err = fabs( zOUT[o] - (double)zcmb_ref(CATALOG.zHEL[o], CATALOG.RA[o],
+					   CATALOG.DEC[o]) );
+    if ( err > R2->ERRMAX ) { R2->ERRMAX = err; }
+  }
+
+  if ( sum < 0.0 ) { printf("%f\n", sum); }
+  free(LAT);  free(zOUT);
+
+} // end bench_zhelio_zcmb_translator
+
+
+// ============================================
+void write_json_BENCH(FILE *fp) {
+
+  int ires ;
+  RESULT_BENCH_DEF *R ;
+  bool PASS ;
+
+  fprintf(fp, "{\n");
+  fprintf(fp, "  \"NOBJ\": %d,\n", CATALOG.NOBJ);
+  fprintf(fp, "  \"ZMAX\": %.3f,\n", ZMAX_BENCH);
+  fprintf(fp, "  \"COSPAR\": { \"H0\": %.3f, \"OM\": %.4f, \"OL\": %.4f, "
+	  "\"w0\": %.3f, \"wa\": %.3f },\n",
+	  COSPAR_BENCH[0], COSPAR_BENCH[1], COSPAR_BENCH[2],
+	  COSPAR_BENCH[3], COSPAR_BENCH[4] );
+  fprintf(fp, "  \"TOLMAG\": %.2e,\n", TOLMAG_BENCH);
+  fprintf(fp, "  \"results\": [\n");
+
+  for(ires=0; ires < NRESULT_BENCH; ires++ ) {
+    R    = &RESULT_BENCH[ires];
+    PASS = ( R->TOL <= 0.0 || R->ERRMAX < R->TOL ) ;
+    fprintf(fp, "    { \"name\": \"%s\", \"neval\": %ld, "
+	    "\"evals_per_sec\": %.4e,\n",
+	    R->NAME, R->NEVAL,
+	    (R->TIME_TOT > 0.0) ? (double)R->NEVAL/R->TIME_TOT : 0.0 );
+    fprintf(fp, "      \"latency_ns\": { \"p50\": %.1f, \"p90\": %.1f, "
+	    "\"p99\": %.1f },\n", R->LAT_P50, R->LAT_P90, R->LAT_P99 );
+    fprintf(fp, "      \"max_err\": %.3e, \"err_unit\": \"%s\", "
+	    "\"tol\": %.1e, \"pass\": %s }%s\n",
+	    R->ERRMAX, R->ERRUNIT, R->TOL, PASS ? "true" : "false",
+	    (ires < NRESULT_BENCH-1) ? "," : "" );
+  }
+  fprintf(fp, "  ]\n}\n");
+  fflush(fp);
+
+} // end write_json_BENCH
@@ -0,0 +1,794 @@
+/*********************************************************
+**********************************************************
+
+  Created Oct 2026
+
+  Streaming tool to add cosmology columns to a FITRES-style catalog.
+
+  Usage:
+    sntools_cosmology_catalog.exe <inFile> <outFile> [key=value ...]
+
+  Keys (default):
+    H0, OM, OL, w0, wa  cosmology (70, 0.315, 0.685, -1, 0)
+    HzFUN_FILE          H(z) map; text or binary (NONE)
+    IPREC               precision tier 1=FAST, 2=STANDARD, 3=REFERENCE (2)
+    COORDSYS            eq, J2000 or gal for sky columns (eq)
+    VARNAME_Z           heliocentric redshift column (zHEL)
+    VARNAME_LON         RA or GLON column (RA; GLON for gal)
+    VARNAME_LAT         DEC or GLAT column (DEC; GLAT for gal)
+    ANISO               1 -> add tilted-universe MU column (0)
+    NTHREAD             number of compute threads (ncpu-2, min 1)
+    NBYTE_CHUNK         bytes read per chunk (8000000)
+
+  Each data row (key SN: or ROW:) gets new columns
+    zCMB_CALC  MU_THEORY  DVDZ  [MU_ANISO]
+  computed with eval_COSMO_CATALOG; VARNAMES (and NVAR) are extended
+  to match. Rows with zHEL <= 0 get -9. All other lines (comments,
+  blank lines, documentation) are copied unchanged.
+
+  The catalog is streamed with bounded memory through a ring of
+  2*NTHREAD+2 chunks: a reader thread reads raw blocks (no parsing),
+  NTHREAD compute threads parse, evaluate and format chunks in any
+  order, and the main thread writes chunks in input order. Output
+  row order is therefore identical to input row order.
+
+  Build (from SNANA src, same objects as other SNANA programs):
+    gcc -O3 -o sntools_cosmology_catalog.exe sntools_cosmology_catalog.c \
+        sntools_cosmology.o sntools.o <other sntools objects> -lm -lpthread
+  If sntools_cosmology.o is compiled with -fopenmp, run with
+  OMP_NUM_THREADS=1 to avoid nested threads.
+
+**********************************************************
+**********************************************************/
+
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#include "sntools.h"
+#include "sntools_cosmology.h"
+
+#define NBYTE_CHUNK_CATALOG  8000000  // default bytes read per chunk
+#define MXTHREAD_CATALOG     256
+#define MXCHAR_VARNAME_CATALOG  60
+#define NBYTE_ADD_CATALOG    80       // max bytes appended per row
+#define VALUE_INVALID_CATALOG  -9.0
+
+#define ISTAT_SLOT_EMPTY  0   // free for reader
+#define ISTAT_SLOT_READ   1   // raw text ready for compute
+#define ISTAT_SLOT_BUSY   2   // compute in progress
+#define ISTAT_SLOT_DONE   3   // output text ready for writer
+
+#define ILINE_PASS      0     // copy line unchanged
+#define ILINE_ROW       1     // data row
+#define ILINE_VARNAMES  2
+
+typedef struct {
+  char   *inFile, *outFile ;
+  double COSPAR[NCOSPAR_HzFUN] ;
+  char   HzFUN_FILE[MXPATHLEN] ;
+  int    IPREC ;
+  char   COORDSYS[20] ;
+  int    ICOORDSYS ;
+  char   VARNAME_Z[MXCHAR_VARNAME_CATALOG] ;
+  char   VARNAME_LON[MXCHAR_VARNAME_CATALOG] ;
+  char   VARNAME_LAT[MXCHAR_VARNAME_CATALOG] ;
+  bool   USE_ANISO ;
+  int    NTHREAD ;
+  long   NBYTE_CHUNK ;
+} INPUTS_CATALOG_DEF ;
+
+typedef struct {
+  int    ISTAT ;              // ISTAT_SLOT_XXX
+  long   ISEQ ;               // chunk index in input order
+  char   *IN ;                // raw text (complete lines)
+  size_t NBYTE_IN, MXBYTE_IN ;
+  char   *OUT ;               // output text
+  size_t NBYTE_OUT, MXBYTE_OUT ;
+  int    NROW, MXROW ;
+  double *zHEL, *LON, *LAT, *zCMB, *MU, *DVDZ, *MU_ANISO ;
+} SLOT_CATALOG_DEF ;
+
+typedef struct {
+  pthread_mutex_t MUTEX ;
+  pthread_cond_t  COND ;
+  int    NSLOT ;
+  SLOT_CATALOG_DEF *SLOT ;
+  long   NSEQ_READ ;          // number of chunks read
+  long   NSEQ_COMPUTE ;       // next chunk for a compute thread
+  bool   DONE_READ ;
+  FILE   *FP_IN ;
+  char   *CARRY ;             // partial last line of previous block
+  size_t NBYTE_CARRY, MXBYTE_CARRY ;
+  long   NROW_TOT ;           // updated by compute threads
+  size_t NBYTE_TOT ;          // updated by reader
+} PIPE_CATALOG_DEF ;
+
+INPUTS_CATALOG_DEF  INPUTS ;
+PIPE_CATALOG_DEF    PIPE ;
+HzFUN_INFO_DEF      HzFUN_INFO ;
+ANISOTROPY_INFO_DEF ANISOTROPY_INFO ;
+
+int  NVAR_CATALOG ;           // number of input VARNAMES
+int  IVAR_Z_CATALOG, IVAR_LON_CATALOG, IVAR_LAT_CATALOG ;
+
+// function prototypes
+void   parse_args_CATALOG(int argc, char **argv);
+void   init_cosmo_CATALOG(void);
+void   copy_header_CATALOG(FILE *fp_in, FILE *fp_out);
+void   parse_varnames_CATALOG(char *LINE);
+void   run_pipe_CATALOG(FILE *fp_in, FILE *fp_out);
+void  *thread_read_CATALOG(void *arg);
+void  *thread_compute_CATALOG(void *arg);
+bool   read_chunk_CATALOG(SLOT_CATALOG_DEF *SLOT);
+void   process_chunk_CATALOG(SLOT_CATALOG_DEF *SLOT);
+int    classify_line_CATALOG(char *LINE, char *LINE_END);
+void   parse_row_CATALOG(char *LINE, char *LINE_END,
+			 double *z, double *lon, double *lat);
+void   alloc_rows_CATALOG(int NROW, SLOT_CATALOG_DEF *SLOT);
+void   grow_buffer_CATALOG(char **BUF, size_t *MXBYTE, size_t NBYTE);
+double time_now_CATALOG(void);
+
+
+// ============================================
+int main(int argc, char **argv) {
+
+  FILE   *fp_in, *fp_out ;
+  double t0, t1 ;
+  char   fnam[] = "main" ;
+
+  // ----------- BEGIN ------------
+
+  t0 = time_now_CATALOG();
+
+  parse_args_CATALOG(argc, argv);
+  init_cosmo_CATALOG();
+
+  fp_in = fopen(INPUTS.inFile, "rt");
+  if ( !fp_in ) {
+    sprintf(c1err,"Cannot open input catalog");
+    sprintf(c2err,"%s", INPUTS.inFile);
+    errmsg(SEV_FATAL, 0, fnam, c1err, c2err);
+  }
+  fp_out = fopen(INPUTS.outFile, "wt");
+  if ( !fp_out ) {
+    sprintf(c1err,"Cannot open output catalog");
+    sprintf(c2err,"%s", INPUTS.outFile);
+    errmsg(SEV_FATAL, 0, fnam, c1err, c2err);
+  }
+
+  copy_header_CATALOG(fp_in, fp_out);
+  run_pipe_CATALOG(fp_in, fp_out);
+
+  fclose(fp_in);
+  if ( fclose(fp_out) != 0 ) {
+    sprintf(c1err,"Error closing output catalog");
+    sprintf(c2err,"%s", INPUTS.outFile);
+    errmsg(SEV_FATAL, 0, fnam, c1err, c2err);
+  }
+
+  t1 = time_now_CATALOG();
+  printf("   Processed %ld rows (%.1f MB) in %.2f sec: "
+	 "%.3e rows/sec, %.1f MB/sec\n",
+	 PIPE.NROW_TOT, 1.0E-6*(double)PIPE.NBYTE_TOT, t1-t0,
+	 (double)PIPE.NROW_TOT/(t1-t0),
+	 1.0E-6*(double)PIPE.NBYTE_TOT/(t1-t0) );
+  printf("   Wrote %s \n", INPUTS.outFile);
+  fflush(stdout);
+
+  return 0 ;
+
+} // end main
+
+
+// ============================================
+void parse_args_CATALOG(int argc, char **argv) {
+
+  // Parse <inFile> <outFile> [key=value ...]; see usage at top.
+
+  int  i, NCPU ;
+  char *ARG, *VAL, KEY[MXCHAR_VARNAME_CATALOG] ;
+  bool SET_LON = false, SET_LAT = false ;
+  char fnam[] = "parse_args_CATALOG" ;
+
+  // ----------- BEGIN ------------
+
+  if ( argc < 3 ) {
+    sprintf(c1err,"Usage: %s <inFile> <outFile> [key=value ...]", argv[0]);
+    sprintf(c2err,"See comments at top of sntools_cosmology_catalog.c");
+    errmsg(SEV_FATAL, 0, fnam, c1err, c2err);
+  }
+
+  INPUTS.inFile  = argv[1] ;
+  INPUTS.outFile = argv[2] ;
+  INPUTS.COSPAR[ICOSPAR_HzFUN_H0] = 70.0 ;
+  INPUTS.COSPAR[ICOSPAR_HzFUN_OM] = 0.315 ;
+  INPUTS.COSPAR[ICOSPAR_HzFUN_OL] = 0.685 ;
+  INPUTS.COSPAR[ICOSPAR_HzFUN_w0] = -1.0 ;
+  INPUTS.COSPAR[ICOSPAR_HzFUN_wa] = 0.0 ;
+  sprintf(INPUTS.HzFUN_FILE,  "NONE");
+  sprintf(INPUTS.COORDSYS,    "eq");
+  sprintf(INPUTS.VARNAME_Z,   "zHEL");
+  sprintf(INPUTS.VARNAME_LON, "RA");
+  sprintf(INPUTS.VARNAME_LAT, "DEC");
+  INPUTS.IPREC       = IPREC_HzFUN_STANDARD ;
+  INPUTS.USE_ANISO   = false ;
+  INPUTS.NBYTE_CHUNK = NBYTE_CHUNK_CATALOG ;
+
+  NCPU = (int)sysconf(_SC_NPROCESSORS_ONLN);
+  INPUTS.NTHREAD = ( NCPU > 3 ) ? NCPU - 2 : 1 ;
+
+  for(i=3; i < argc; i++ ) {
+    ARG = argv[i] ;
+    VAL = strchr(ARG,'=');
+    if ( VAL == NULL || VAL-ARG >= MXCHAR_VARNAME_CATALOG ) {
+      sprintf(c1err,"Invalid argument '%s'", ARG);
+      sprintf(c2err,"Expect key=value");
+      errmsg(SEV_FATAL, 0, fnam, c1err, c2err);
+    }
+    sprintf(KEY, "%.*s", (int)(VAL-ARG), ARG);  VAL++ ;
+
+    if      ( strcmp(KEY,"H0") == 0 )
+      { INPUTS.COSPAR[ICOSPAR_HzFUN_H0] = atof(VAL); }
+    else if ( strcmp(KEY,"OM") == 0 )
+      { INPUTS.COSPAR[ICOSPAR_HzFUN_OM] = atof(VAL); }
+    else if ( strcmp(KEY,"OL") == 0 )
+      { INPUTS.COSPAR[ICOSPAR_HzFUN_OL] = atof(VAL); }
+    else if ( strcmp(KEY,"w0") == 0 )
+      { INPUTS.COSPAR[ICOSPAR_HzFUN_w0] = atof(VAL); }
+    else if ( strcmp(KEY,"wa") == 0 )
+      { INPUTS.COSPAR[ICOSPAR_HzFUN_wa] = atof(VAL); }
+    else if ( strcmp(KEY,"HzFUN_FILE") == 0 )
+      { snprintf(INPUTS.HzFUN_FILE, MXPATHLEN, "%s", VAL); }
+    else if ( strcmp(KEY,"IPREC") == 0 )
+      { INPUTS.IPREC = atoi(VAL); }
+    else if ( strcmp(KEY,"COORDSYS") == 0 )
+      { snprintf(INPUTS.COORDSYS, 20, "%s", VAL); }
+    else if ( strcmp(KEY,"VARNAME_Z") == 0 )
+      { snprintf(INPUTS.VARNAME_Z, MXCHAR_VARNAME_CATALOG, "%s", VAL); }
+    else if ( strcmp(KEY,"VARNAME_LON") == 0 ) {
+      snprintf(INPUTS.VARNAME_LON, MXCHAR_VARNAME_CATALOG, "%s", VAL);
+      SET_LON = true ;
+    }
+    else if ( strcmp(KEY,"VARNAME_LAT") == 0 ) {
+      snprintf(INPUTS.VARNAME_LAT, MXCHAR_VARNAME_CATALOG, "%s", VAL);
+      SET_LAT = true ;
+    }
+    else if ( strcmp(KEY,"ANISO") == 0 )
+      { INPUTS.USE_ANISO = ( atoi(VAL) > 0 ) ; }
+    else if ( strcmp(KEY,"NTHREAD") == 0 )
+      { INPUTS.NTHREAD = atoi(VAL); }
+    else if ( strcmp(KEY,"NBYTE_CHUNK") == 0 )
+      { INPUTS.NBYTE_CHUNK = atol(VAL); }
+    else {
+      sprintf(c1err,"Unknown key '%s'", KEY);
+      sprintf(c2err,"See comments at top of sntools_cosmology_catalog.c");
+      errmsg(SEV_FATAL, 0, fnam, c1err, c2err);
+    }
+  }
+
+  INPUTS.ICOORDSYS = index_COORDSYS(INPUTS.COORDSYS);
+  if ( INPUTS.ICOORDSYS == ICOORDSYS_GAL ) {
+    if ( !SET_LON ) { sprintf(INPUTS.VARNAME_LON, "GLON"); }
+    if ( !SET_LAT ) { sprintf(INPUTS.VARNAME_LAT, "GLAT"); }
+  }
+
+  if ( INPUTS.NTHREAD < 1 || INPUTS.NTHREAD > MXTHREAD_CATALOG ) {
+    sprintf(c1err,"Invalid NTHREAD = %d", INPUTS.NTHREAD);
+    sprintf(c2err,"Valid range is 1 to %d", MXTHREAD_CATALOG);
+    errmsg(SEV_FATAL, 0, fnam, c1err, c2err);
+  }
+  if ( INPUTS.NBYTE_CHUNK < 1000 ) { INPUTS.NBYTE_CHUNK = 1000; }
+
+} // end parse_args_CATALOG
+
+
+// ============================================
+void init_cosmo_CATALOG(void) {
+
+  // Initialize cosmology (with distance tables) and anisotropy model;
+  // both are read-only for the compute threads.
+
+  init_HzFUN_INFO(1, INPUTS.COSPAR, INPUTS.HzFUN_FILE, &HzFUN_INFO);
+  set_HzFUN_PRECISION(1, INPUTS.IPREC, &HzFUN_INFO);
+
+  init_ANISOTROPY_INFO(&ANISOTROPY_INFO);
+  ANISOTROPY_INFO.USE_FLAG = INPUTS.USE_ANISO ;
+
+  printf("   Catalog %s -> %s \n", INPUTS.inFile, INPUTS.outFile);
+  printf("   Columns %s, %s, %s (COORDSYS=%s); %d compute threads\n",
+	 INPUTS.VARNAME_Z, INPUTS.VARNAME_LON, INPUTS.VARNAME_LAT,
+	 INPUTS.COORDSYS, INPUTS.NTHREAD );
+  fflush(stdout);
+
+} // end init_cosmo_CATALOG
+
+
+// ============================================
+void copy_header_CATALOG(FILE *fp_in, FILE *fp_out) {
+
+  // Copy lines up to and including VARNAMES to output; VARNAMES
+  // (and NVAR if present) are extended with the new columns.
+  // Remaining lines are processed by run_pipe_CATALOG.
+
+  char   *LINE = NULL, *ptr ;
+  size_t MXLINE = 0 ;
+  ssize_t LEN ;
+  int    NADD = INPUTS.USE_ANISO ? 4 : 3 ;
+  char   fnam[] = "copy_header_CATALOG" ;
+
+  // ----------- BEGIN ------------
+
+  NVAR_CATALOG = 0 ;
+  while ( (LEN = getline(&LINE, &MXLINE, fp_in)) > 0 ) {
+
+    PIPE.NBYTE_TOT += LEN ;
+    while ( LEN > 0 && (LINE[LEN-1] == '\n' || LINE[LEN-1] == '\r') )
+      { LINE[--LEN] = 0 ; }
+
+    switch ( classify_line_CATALOG(LINE, LINE+LEN) ) {
+    case ILINE_ROW :
+      sprintf(c1err,"Found data row before VARNAMES:");
+      sprintf(c2err,"%.100s", LINE);
+      errmsg(SEV_FATAL, 0, fnam, c1err, c2err);
+      break ;
+
+    case ILINE_VARNAMES :
+      parse_varnames_CATALOG(LINE);
+      fprintf(fp_out, "%s  zCMB_CALC MU_THEORY DVDZ%s\n", LINE,
+	      INPUTS.USE_ANISO ? " MU_ANISO" : "" );
+      free(LINE);
+      return ;
+
+    default :
+      ptr = LINE ;
+      while ( *ptr == ' ' ) { ptr++ ; }
+      if ( strncmp(ptr,"NVAR:",5) == 0 )
+	{ fprintf(fp_out, "NVAR: %d\n", atoi(ptr+5) + NADD); }
+      else
+	{ fprintf(fp_out, "%s\n", LINE); }
+    }
+  }
+
+  sprintf(c1err,"Could not find VARNAMES key in");
+  sprintf(c2err,"%s", INPUTS.inFile);
+  errmsg(SEV_FATAL, 0, fnam, c1err, c2err);
+
+} // end copy_header_CATALOG
+
+
+// ============================================
+void parse_varnames_CATALOG(char *LINE) {
+
+  // Find column index (0 = first column after VARNAMES:) of
+  // redshift and sky-coordinate columns.
+
+  char *VARNAME, *SAVEPTR = NULL ;
+  char fnam[] = "parse_varnames_CATALOG" ;
+
+  IVAR_Z_CATALOG = IVAR_LON_CATALOG = IVAR_LAT_CATALOG = -9 ;
+  NVAR_CATALOG   = 0 ;
+
+  strtok_r(LINE, " \t", &SAVEPTR);     // skip VARNAMES:
+  while ( (VARNAME = strtok_r(NULL, " \t", &SAVEPTR)) != NULL ) {
+    if ( strcmp(VARNAME,INPUTS.VARNAME_Z)   == 0 )
+      { IVAR_Z_CATALOG   = NVAR_CATALOG; }
+    if ( strcmp(VARNAME,INPUTS.VARNAME_LON) == 0 )
+      { IVAR_LON_CATALOG = NVAR_CATALOG; }
+    if ( strcmp(VARNAME,INPUTS.VARNAME_LAT) == 0 )
+      { IVAR_LAT_CATALOG = NVAR_CATALOG; }
+    NVAR_CATALOG++ ;
+  }
+
+  // strtok_r replaced separators with 0; restore for output
+  for(VARNAME=LINE; VARNAME < SAVEPTR-1; VARNAME++ )
+    { if ( *VARNAME == 0 ) { *VARNAME = ' '; } }
+
+  if ( IVAR_Z_CATALOG < 0 || IVAR_LON_CATALOG < 0 ||
+       IVAR_LAT_CATALOG < 0 ) {
+    sprintf(c1err,"Missing column: %.40s(%d) %.40s(%d) %.40s(%d)",
+	    INPUTS.VARNAME_Z, IVAR_Z_CATALOG,
+	    INPUTS.VARNAME_LON, IVAR_LON_CATALOG,
+	    INPUTS.VARNAME_LAT, IVAR_LAT_CATALOG );
+    sprintf(c2err,"Check VARNAMES or VARNAME_XXX arguments");
+    errmsg(SEV_FATAL, 0, fnam, c1err, c2err);
+  }
+
+} // end parse_varnames_CATALOG
+
+
+// ============================================
+void run_pipe_CATALOG(FILE *fp_in, FILE *fp_out) {
+
+  // Stream remaining lines of fp_in through reader -> compute ->
+  // writer pipeline. The writer (this thread) waits for chunk ISEQ
+  // before writing it, so that output order = input order.
+
+  int    NTHREAD = INPUTS.NTHREAD ;
+  int    islot, ithread ;
+  long   ISEQ ;
+  pthread_t THREAD_READ, THREAD_COMPUTE[MXTHREAD_CATALOG] ;
+  SLOT_CATALOG_DEF *SLOT ;
+  char   fnam[] = "run_pipe_CATALOG" ;
+
+  // ----------- BEGIN ------------
+
+  PIPE.NSLOT = 2*NTHREAD + 2 ;
+  PIPE.SLOT  = (SLOT_CATALOG_DEF*) calloc(PIPE.NSLOT,
+					  sizeof(SLOT_CATALOG_DEF));
+  for(islot=0; islot < PIPE.NSLOT; islot++ )
+    { PIPE.SLOT[islot].ISTAT = ISTAT_SLOT_EMPTY ; }
+  PIPE.NSEQ_READ    = 0 ;
+  PIPE.NSEQ_COMPUTE = 0 ;
+  PIPE.DONE_READ    = false ;
+  PIPE.FP_IN        = fp_in ;
+  PIPE.NROW_TOT     = 0 ;
+  pthread_mutex_init(&PIPE.MUTEX, NULL);
+  pthread_cond_init(&PIPE.COND, NULL);
+
+  pthread_create(&THREAD_READ, NULL, thread_read_CATALOG, NULL);
+  for(ithread=0; ithread < NTHREAD; ithread++ ) {
+    pthread_create(&THREAD_COMPUTE[ithread], NULL,
+		   thread_compute_CATALOG, NULL);
+  }
+
+  for(ISEQ=0; ; ISEQ++ ) {
+    SLOT = &PIPE.SLOT[ISEQ % PIPE.NSLOT] ;
+
+    pthread_mutex_lock(&PIPE.MUTEX);
+    while ( !(SLOT->ISTAT == ISTAT_SLOT_DONE && SLOT->ISEQ == ISEQ) &&
+	    !(PIPE.DONE_READ && ISEQ >= PIPE.NSEQ_READ) )
+      { pthread_cond_wait(&PIPE.COND, &PIPE.MUTEX); }
+    if ( SLOT->ISTAT != ISTAT_SLOT_DONE || SLOT->ISEQ != ISEQ )
+      { pthread_mutex_unlock(&PIPE.MUTEX);  break; }
+    pthread_mutex_unlock(&PIPE.MUTEX);
+
+    if ( fwrite(SLOT->OUT, 1, SLOT->NBYTE_OUT, fp_out) != SLOT->NBYTE_OUT ) {
+      sprintf(c1err,"Error writing chunk %ld", ISEQ);
+      sprintf(c2err,"to %s", INPUTS.outFile);
+      errmsg(SEV_FATAL, 0, fnam, c1err, c2err);
+    }
+
+    pthread_mutex_lock(&PIPE.MUTEX);
+    SLOT->ISTAT = ISTAT_SLOT_EMPTY ;
+    pthread_cond_broadcast(&PIPE.COND);
+    pthread_mutex_unlock(&PIPE.MUTEX);
+  }
+
+  pthread_join(THREAD_READ, NULL);
+  for(ithread=0; ithread < NTHREAD; ithread++ )
+    { pthread_join(THREAD_COMPUTE[ithread], NULL); }
+
+  for(islot=0; islot < PIPE.NSLOT; islot++ ) {
+    SLOT = &PIPE.SLOT[islot] ;
+    free(SLOT->IN);  free(SLOT->OUT);
+    if ( SLOT->MXROW > 0 ) {
+      free(SLOT->zHEL);
+      free(SLOT->LON);   free(SLOT->LAT);
+      free(SLOT->zCMB);  free(SLOT->MU);   free(SLOT->DVDZ);
+      free(SLOT->MU_ANISO);
+    }
+  }
+  free(PIPE.SLOT);  free(PIPE.CARRY);
+  pthread_mutex_destroy(&PIPE.MUTEX);
+  pthread_cond_destroy(&PIPE.COND);
+
+} // end run_pipe_CATALOG
+
+
+// ============================================
+void *thread_read_CATALOG(void *arg) {
+
+  // Reader thread: fill empty slots in sequence with raw blocks of
+  // complete lines. No parsing here, so reading runs at disk speed.
+
+  long ISEQ ;
+  bool MORE = true ;
+  SLOT_CATALOG_DEF *SLOT ;
+
+  (void)arg ;  // unused; required by pthread_create
+
+  for(ISEQ=0; MORE; ISEQ++ ) {
+    SLOT = &PIPE.SLOT[ISEQ % PIPE.NSLOT] ;
+
+    pthread_mutex_lock(&PIPE.MUTEX);
+    while ( SLOT->ISTAT != ISTAT_SLOT_EMPTY )
+      { pthread_cond_wait(&PIPE.COND, &PIPE.MUTEX); }
+    pthread_mutex_unlock(&PIPE.MUTEX);
+
+    MORE = read_chunk_CATALOG(SLOT);
+    if ( SLOT->NBYTE_IN == 0 ) { break; }
+
+    pthread_mutex_lock(&PIPE.MUTEX);
+    SLOT->ISEQ  = ISEQ ;
+    SLOT->ISTAT = ISTAT_SLOT_READ ;
+    PIPE.NSEQ_READ++ ;
+    pthread_cond_broadcast(&PIPE.COND);
+    pthread_mutex_unlock(&PIPE.MUTEX);
+  }
+
+  pthread_mutex_lock(&PIPE.MUTEX);
+  PIPE.DONE_READ = true ;
+  pthread_cond_broadcast(&PIPE.COND);
+  pthread_mutex_unlock(&PIPE.MUTEX);
+
+  return NULL ;
+
+} // end thread_read_CATALOG
+
+
+// ============================================
+bool read_chunk_CATALOG(SLOT_CATALOG_DEF *SLOT) {
+
+  // Fill SLOT->IN with partial line carried from previous block plus
+  // next NBYTE_CHUNK bytes, and carry the incomplete last line to
+  // the next block. A line longer than NBYTE_CHUNK grows the block.
+  // Returns false at end of file.
+
+  size_t NBYTE = INPUTS.NBYTE_CHUNK, NREAD, NKEEP ;
+  char   *ptr ;
+  bool   MORE = true ;
+
+  // ----------- BEGIN ------------
+
+  grow_buffer_CATALOG(&SLOT->IN, &SLOT->MXBYTE_IN,
+		      PIPE.NBYTE_CARRY + NBYTE + 1);
+  memcpy(SLOT->IN, PIPE.CARRY, PIPE.NBYTE_CARRY);
+  SLOT->NBYTE_IN = PIPE.NBYTE_CARRY ;
+
+  while ( 1 ) {
+    NREAD = fread(SLOT->IN + SLOT->NBYTE_IN, 1, NBYTE, PIPE.FP_IN);
+    SLOT->NBYTE_IN += NREAD ;
+    PIPE.NBYTE_TOT += NREAD ;
+    if ( NREAD < NBYTE ) { MORE = false;  break; }   // end of file
+
+    // find last newline; if none, grow and keep reading
+    ptr = SLOT->IN + SLOT->NBYTE_IN ;
+    while ( ptr > SLOT->IN && ptr[-1] != '\n' ) { ptr-- ; }
+    if ( ptr > SLOT->IN ) { break; }
+    grow_buffer_CATALOG(&SLOT->IN, &SLOT->MXBYTE_IN,
+			SLOT->NBYTE_IN + NBYTE + 1);
+  }
+
+  PIPE.NBYTE_CARRY = 0 ;
+  if ( MORE ) {
+    ptr   = SLOT->IN + SLOT->NBYTE_IN ;
+    while ( ptr[-1] != '\n' ) { ptr-- ; }
+    NKEEP = SLOT->IN + SLOT->NBYTE_IN - ptr ;
+    grow_buffer_CATALOG(&PIPE.CARRY, &PIPE.MXBYTE_CARRY, NKEEP+1);
+    memcpy(PIPE.CARRY, ptr, NKEEP);
+    PIPE.NBYTE_CARRY = NKEEP ;
+    SLOT->NBYTE_IN  -= NKEEP ;
+  }
+
+  return MORE ;
+
+} // end read_chunk_CATALOG
+
+
+// ============================================
+void *thread_compute_CATALOG(void *arg) {
+
+  // Compute thread: take chunks in sequence (any thread may take
+  // the next one), and process them concurrently.
+
+  SLOT_CATALOG_DEF *SLOT ;
+  long ISEQ ;
+
+  (void)arg ;  // unused; required by pthread_create
+
+  while ( 1 ) {
+    pthread_mutex_lock(&PIPE.MUTEX);
+    while ( PIPE.NSEQ_COMPUTE >= PIPE.NSEQ_READ && !PIPE.DONE_READ )
+      { pthread_cond_wait(&PIPE.COND, &PIPE.MUTEX); }
+    if ( PIPE.NSEQ_COMPUTE >= PIPE.NSEQ_READ )
+      { pthread_mutex_unlock(&PIPE.MUTEX);  break; }
+    ISEQ = PIPE.NSEQ_COMPUTE++ ;
+    SLOT = &PIPE.SLOT[ISEQ % PIPE.NSLOT] ;
+    SLOT->ISTAT = ISTAT_SLOT_BUSY ;
+    pthread_mutex_unlock(&PIPE.MUTEX);
+
+    process_chunk_CATALOG(SLOT);
+
+    pthread_mutex_lock(&PIPE.MUTEX);
+    SLOT->ISTAT = ISTAT_SLOT_DONE ;
+    PIPE.NROW_TOT += SLOT->NROW ;
+    pthread_cond_broadcast(&PIPE.COND);
+    pthread_mutex_unlock(&PIPE.MUTEX);
+  }
+
+  return NULL ;
+
+} // end thread_compute_CATALOG
+
+
+// ============================================
+void process_chunk_CATALOG(SLOT_CATALOG_DEF *SLOT) {
+
+  // Parse data rows of SLOT->IN, evaluate cosmology columns for all
+  // rows at once (eval_COSMO_CATALOG), and write SLOT->OUT with the
+  // new columns appended to each data row.
+
+  char   *IN_END = SLOT->IN + SLOT->NBYTE_IN ;
+  char   *LINE, *LINE_END, *COPY_END, *OUT ;
+  int    NLINE = 0, NROW = 0, irow, ILINE ;
+  char   fnam[] = "process_chunk_CATALOG" ;
+  char   c1loc[200], c2loc[200] ; // local msg for thread safety
+
+  // ----------- BEGIN ------------
+
+  // pass 1: count lines, then parse rows
+  for(LINE=SLOT->IN; LINE < IN_END; LINE++ )
+    { if ( *LINE == '\n' ) { NLINE++ ; } }
+  alloc_rows_CATALOG(NLINE+1, SLOT);
+
+  for(LINE=SLOT->IN; LINE < IN_END; LINE = LINE_END+1 ) {
+    LINE_END = memchr(LINE, '\n', IN_END-LINE);
+    if ( LINE_END == NULL ) { LINE_END = IN_END; }
+    ILINE = classify_line_CATALOG(LINE, LINE_END);
+    if ( ILINE == ILINE_VARNAMES ) {
+      sprintf(c1loc,"Found second VARNAMES key in catalog");
+      sprintf(c2loc,"Concatenated catalogs are not supported");
+      errmsg(SEV_FATAL, 0, fnam, c1loc, c2loc);
+    }
+    if ( ILINE != ILINE_ROW ) { continue; }
+    parse_row_CATALOG(LINE, LINE_END, &SLOT->zHEL[NROW],
+		      &SLOT->LON[NROW], &SLOT->LAT[NROW] );
+    NROW++ ;
+  }
+  SLOT->NROW = NROW ;
+
+  // evaluate; rows with zHEL <= 0 are skipped by eval_COSMO_CATALOG,
+  // and flagged below
+  eval_COSMO_CATALOG(NROW, SLOT->zHEL, SLOT->LON, SLOT->LAT,
+		     INPUTS.ICOORDSYS, &HzFUN_INFO, NULL,
+		     SLOT->zCMB, SLOT->MU, SLOT->DVDZ);
+  if ( INPUTS.USE_ANISO ) {
+    eval_COSMO_CATALOG(NROW, SLOT->zHEL, SLOT->LON, SLOT->LAT,
+		       INPUTS.ICOORDSYS, &HzFUN_INFO, &ANISOTROPY_INFO,
+		       SLOT->zCMB, SLOT->MU_ANISO, NULL);
+  }
+
+  // pass 2: output text
+  grow_buffer_CATALOG(&SLOT->OUT, &SLOT->MXBYTE_OUT,
+		      SLOT->NBYTE_IN + NLINE + 2 +
+		      (size_t)NROW * NBYTE_ADD_CATALOG );
+  OUT  = SLOT->OUT ;
+  irow = 0 ;
+  for(LINE=SLOT->IN; LINE < IN_END; LINE = LINE_END+1 ) {
+    LINE_END = memchr(LINE, '\n', IN_END-LINE);
+    if ( LINE_END == NULL ) { LINE_END = IN_END; }
+    ILINE = classify_line_CATALOG(LINE, LINE_END);
+
+    COPY_END = LINE_END ;
+    while ( COPY_END > LINE && (COPY_END[-1] == '\r') ) { COPY_END-- ; }
+    if ( ILINE == ILINE_ROW )
+      { while ( COPY_END > LINE && COPY_END[-1] == ' ' ) { COPY_END-- ; } }
+    memcpy(OUT, LINE, COPY_END-LINE);  OUT += COPY_END-LINE ;
+
+    if ( ILINE == ILINE_ROW ) {
+      if ( SLOT->zHEL[irow] > 0.0 ) {
+	OUT += sprintf(OUT, "  %.6f %.5f %.5e", SLOT->zCMB[irow],
+		       SLOT->MU[irow], SLOT->DVDZ[irow] );
+	if ( INPUTS.USE_ANISO )
+	  { OUT += sprintf(OUT, " %.5f", SLOT->MU_ANISO[irow]); }
+      }
+      else {
+	OUT += sprintf(OUT, "  %.1f %.1f %.1f", VALUE_INVALID_CATALOG,
+		       VALUE_INVALID_CATALOG, VALUE_INVALID_CATALOG );
+	if ( INPUTS.USE_ANISO )
+	  { OUT += sprintf(OUT, " %.1f", VALUE_INVALID_CATALOG); }
+      }
+      irow++ ;
+    }
+    *OUT++ = '\n' ;
+  }
+  SLOT->NBYTE_OUT = OUT - SLOT->OUT ;
+
+} // end process_chunk_CATALOG
+
+
+// ============================================
+int classify_line_CATALOG(char *LINE, char *LINE_END) {
+
+  // Return ILINE_ROW for data row (first word SN: or ROW:),
+  // ILINE_VARNAMES for VARNAMES, and ILINE_PASS otherwise.
+
+  char *ptr = LINE ;
+  while ( ptr < LINE_END && (*ptr == ' ' || *ptr == '\t') ) { ptr++ ; }
+  if ( LINE_END - ptr < 4 ) { return ILINE_PASS ; }
+
+  if ( strncmp(ptr,"SN:" ,3) == 0 ) { return ILINE_ROW ; }
+  if ( strncmp(ptr,"ROW:",4) == 0 ) { return ILINE_ROW ; }
+  if ( LINE_END - ptr >= 9 && strncmp(ptr,"VARNAMES:",9) == 0 )
+    { return ILINE_VARNAMES ; }
+  return ILINE_PASS ;
+
+} // end classify_line_CATALOG
+
+
+// ============================================
+void parse_row_CATALOG(char *LINE, char *LINE_END,
+		       double *z, double *lon, double *lat) {
+
+  // Extract redshift and sky coordinates from data row. Words are
+  // separated by blanks; word 0 is the row key (SN: or ROW:).
+
+  char *ptr = LINE, *WORD ;
+  int  ivar = -1, NFOUND = 0 ;
+  char fnam[] = "parse_row_CATALOG" ;
+  char c1loc[200], c2loc[200] ; // local msg for thread safety
+
+  while ( ptr < LINE_END && NFOUND < 3 ) {
+    while ( ptr < LINE_END && (*ptr == ' ' || *ptr == '\t') ) { ptr++ ; }
+    if ( ptr >= LINE_END || *ptr == '\r' ) { break; }
+    WORD = ptr ;
+    while ( ptr < LINE_END && *ptr != ' ' && *ptr != '\t' ) { ptr++ ; }
+
+    if ( ivar == IVAR_Z_CATALOG   ) { *z   = atof(WORD);  NFOUND++ ; }
+    if ( ivar == IVAR_LON_CATALOG ) { *lon = atof(WORD);  NFOUND++ ; }
+    if ( ivar == IVAR_LAT_CATALOG ) { *lat = atof(WORD);  NFOUND++ ; }
+    ivar++ ;
+  }
+
+  if ( NFOUND < 3 ) {
+    sprintf(c1loc,"Found %d of 3 required columns in row:", NFOUND);
+    sprintf(c2loc,"%.100s", LINE);
+    errmsg(SEV_FATAL, 0, fnam, c1loc, c2loc);
+  }
+
+} // end parse_row_CATALOG
+
+
+// ============================================
+void alloc_rows_CATALOG(int NROW, SLOT_CATALOG_DEF *SLOT) {
+
+  // Make sure row arrays of SLOT hold at least NROW rows.
+
+  int MEMD ;
+  if ( NROW <= SLOT->MXROW ) { return ; }
+
+  if ( SLOT->MXROW > 0 ) {
+    free(SLOT->zHEL);
+    free(SLOT->LON);   free(SLOT->LAT);
+    free(SLOT->zCMB);  free(SLOT->MU);   free(SLOT->DVDZ);
+    free(SLOT->MU_ANISO);
+  }
+  MEMD = NROW * sizeof(double) ;
+  SLOT->zHEL     = (double*) malloc(MEMD);
+  SLOT->LON      = (double*) malloc(MEMD);
+  SLOT->LAT      = (double*) malloc(MEMD);
+  SLOT->zCMB     = (double*) malloc(MEMD);
+  SLOT->MU       = (double*) malloc(MEMD);
+  SLOT->DVDZ     = (double*) malloc(MEMD);
+  SLOT->MU_ANISO = (double*) malloc(MEMD);
+  SLOT->MXROW    = NROW ;
+
+} // end alloc_rows_CATALOG
+
+
+// ============================================
+void grow_buffer_CATALOG(char **BUF, size_t *MXBYTE, size_t NBYTE) {
+
+  // Make sure *BUF holds at least NBYTE bytes (contents are kept).
+
+  char fnam[] = "grow_buffer_CATALOG" ;
+  char c1loc[200], c2loc[200] ; // local msg for thread safety
+
+  if ( NBYTE <= *MXBYTE ) { return ; }
+  *BUF = (char*) realloc(*BUF, NBYTE);
+  if ( *BUF == NULL ) {
+    sprintf(c1loc,"Unable to allocate %ld bytes", (long)NBYTE);
+    sprintf(c2loc,"Reduce NBYTE_CHUNK or NTHREAD");
+    errmsg(SEV_FATAL, 0, fnam, c1loc, c2loc);
+  }
+  *MXBYTE = NBYTE ;
+
+} // end grow_buffer_CATALOG
+
+
+// ============================================
+double time_now_CATALOG(void) {
+  struct timespec ts ;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + 1.0E-9*(double)ts.tv_nsec ;
+} // end time_now_CATALOG